@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ofxContentsManager.h"
+
+#if (OF_VERSION_MAJOR == 0 && OF_VERSION_MINOR <= 8)
+#define ofDrawRectangle ofRect
+#endif
+
+// Content with configurable CPU and draw cost
+class SyntheticContent : public ofxContentsManager::Content
+{
+    int     mCpuIterations;
+    int     mNumRects;
+    float   mValue;
+    
+public:
+    SyntheticContent(int cpuIterations, int numRects)
+    : mCpuIterations(cpuIterations)
+    , mNumRects(numRects)
+    , mValue(0)
+    {
+    }
+    
+    void update()
+    {
+        float v = mValue;
+        for (int i = 0; i < mCpuIterations; ++i)
+        {
+            v = sinf(v + i * 0.001f);
+        }
+        mValue = v;
+    }
+    
+    void draw()
+    {
+        const float w = getWidth() / 8;
+        const float h = getHeight() / 8;
+        for (int i = 0; i < mNumRects; ++i)
+        {
+            ofSetColor(ofColor::fromHsb((i * 37) % 255, 200, 255), 128);
+            ofDrawRectangle((i % 8) * w, ((i / 8) % 8) * h, w, h);
+        }
+    }
+};
+
+// a second type, so the manager holds more than one type ID
+class SyntheticContentB : public SyntheticContent
+{
+public:
+    SyntheticContentB(int cpuIterations, int numRects) : SyntheticContent(cpuIterations, numRects){}
+};
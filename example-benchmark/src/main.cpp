@@ -0,0 +1,25 @@
+#include "ofMain.h"
+#include "ofApp.h"
+
+//========================================================================
+// Headless usage on Linux (Mesa llvmpipe):
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./bin/example-benchmark --counts=10,100,1000 --format=json --output=result.json
+//
+// Options: --counts --width --height --visible --frames --cpu --rects --pool --compositor --format(csv|json) --output
+int main(int argc, char* argv[]){
+    
+    BenchmarkSettings settings;
+    settings.parse(argc, argv);
+    
+#if (OF_VERSION_MAJOR == 0 && OF_VERSION_MINOR < 9)
+    ofSetupOpenGL(settings.width, settings.height, OF_WINDOW);
+#else
+    ofGLFWWindowSettings windowSettings;
+    windowSettings.width = settings.width;
+    windowSettings.height = settings.height;
+    windowSettings.visible = false;
+    ofCreateWindow(windowSettings);
+#endif
+    
+    ofRunApp(new ofApp(settings));
+}
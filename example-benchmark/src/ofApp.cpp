@@ -0,0 +1,200 @@
+#include "ofApp.h"
+#include "SyntheticContent.h"
+
+//--------------------------------------------------------------
+BenchmarkSettings::BenchmarkSettings()
+: width(256)
+, height(256)
+, visible(4)
+, frames(60)
+, cpuIterations(1000)
+, numRects(16)
+, pool(true)
+, compositor(false)
+, format("csv")
+{
+    counts.push_back(10);
+    counts.push_back(100);
+    counts.push_back(1000);
+    counts.push_back(10000);
+}
+
+//--------------------------------------------------------------
+void BenchmarkSettings::parse(int argc, char* argv[]){
+    
+    for (int i = 1; i < argc; ++i)
+    {
+        const string arg = argv[i];
+        const size_t eq = arg.find('=');
+        if (arg.compare(0, 2, "--") != 0 || eq == string::npos)
+        {
+            ofLogWarning("benchmark") << "ignore argument: " << arg;
+            continue;
+        }
+        const string key = arg.substr(2, eq - 2);
+        const string value = arg.substr(eq + 1);
+        
+        if (key == "counts")
+        {
+            counts.clear();
+            for (const auto& c : ofSplitString(value, ",", true, true)) counts.push_back(ofToInt(c));
+        }
+        else if (key == "width")      width = ofToInt(value);
+        else if (key == "height")     height = ofToInt(value);
+        else if (key == "visible")    visible = ofToInt(value);
+        else if (key == "frames")     frames = ofToInt(value);
+        else if (key == "cpu")        cpuIterations = ofToInt(value);
+        else if (key == "rects")      numRects = ofToInt(value);
+        else if (key == "pool")       pool = ofToBool(value);
+        else if (key == "compositor") compositor = ofToBool(value);
+        else if (key == "format")     format = value;
+        else if (key == "output")     output = value;
+        else ofLogWarning("benchmark") << "unknown option: " << key;
+    }
+}
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+    
+    for (const auto& count : mSettings.counts)
+    {
+        runBenchmark(count);
+    }
+    writeResults();
+    ofExit(0);
+}
+
+//--------------------------------------------------------------
+void ofApp::runBenchmark(const int count){
+    
+    ofxContentsManager::Manager manager;
+    manager.setup(mSettings.width, mSettings.height);
+    if (mSettings.pool) manager.enableFboPool(true, mSettings.visible);
+    if (mSettings.compositor) manager.enableCompositor(true);
+    
+    vector<string> names;
+    for (int i = 0; i < count; ++i) names.push_back("synthetic_" + ofToString(i));
+    
+    // addContent
+    uint64_t start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < count; ++i)
+    {
+        ofxContentsManager::Content* c = (i % 2)
+            ? (ofxContentsManager::Content*)manager.addContent<SyntheticContentB>(mSettings.cpuIterations, mSettings.numRects)
+            : (ofxContentsManager::Content*)manager.addContent<SyntheticContent>(mSettings.cpuIterations, mSettings.numRects);
+        c->setName(names[i]);
+    }
+    addResult(count, "addContent", count, ofGetElapsedTimeMicros() - start);
+    
+    // switchContent
+    const int numSwitches = 100;
+    start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < numSwitches; ++i)
+    {
+        manager.switchContent((i * 7919) % count);
+    }
+    addResult(count, "switchContent", numSwitches, ofGetElapsedTimeMicros() - start);
+    
+    // setOpacity(name)
+    const int numSetOpacity = 1000;
+    manager.setOpacityAll(0);
+    start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < numSetOpacity; ++i)
+    {
+        manager.setOpacity(names[(i * 7919) % count], 0);
+    }
+    addResult(count, "setOpacity(name)", numSetOpacity, ofGetElapsedTimeMicros() - start);
+    
+    // update and draw with visible layers spread over the stack
+    const int visible = min(mSettings.visible, count);
+    for (int i = 0; i < visible; ++i)
+    {
+        manager.setOpacity(i * count / visible, 1.0 / visible);
+    }
+    
+    ofFbo output;
+    output.allocate(mSettings.width, mSettings.height, GL_RGBA);
+    
+    uint64_t updateMicros = 0;
+    uint64_t drawMicros = 0;
+    for (int i = 0; i < mSettings.frames; ++i)
+    {
+        start = ofGetElapsedTimeMicros();
+        manager.update();
+        glFinish();
+        updateMicros += ofGetElapsedTimeMicros() - start;
+        
+        output.begin();
+        ofClear(0);
+        start = ofGetElapsedTimeMicros();
+        manager.draw();
+        glFinish();
+        drawMicros += ofGetElapsedTimeMicros() - start;
+        output.end();
+    }
+    addResult(count, "update", mSettings.frames, updateMicros);
+    addResult(count, "draw", mSettings.frames, drawMicros);
+    
+    // removeContent
+    start = ofGetElapsedTimeMicros();
+    for (int i = count - 1; i >= 0; --i)
+    {
+        manager.removeContent(names[i]);
+    }
+    addResult(count, "removeContent(name)", count, ofGetElapsedTimeMicros() - start);
+}
+
+//--------------------------------------------------------------
+void ofApp::addResult(const int count, const string& operation, const int iterations, const uint64_t micros){
+    
+    Result r;
+    r.count = count;
+    r.operation = operation;
+    r.iterations = iterations;
+    r.totalMillis = micros / 1000.0;
+    mResults.push_back(r);
+    ofLogNotice("benchmark") << count << " contents, " << operation << ": " << r.totalMillis << " ms";
+}
+
+//--------------------------------------------------------------
+void ofApp::writeResults(){
+    
+    stringstream ss;
+    if (mSettings.format == "json")
+    {
+        ss << "{\n"
+           << "  \"width\": " << mSettings.width << ", \"height\": " << mSettings.height
+           << ", \"visible\": " << mSettings.visible << ", \"pool\": " << (mSettings.pool ? "true" : "false")
+           << ", \"compositor\": " << (mSettings.compositor ? "true" : "false") << ",\n"
+           << "  \"results\": [\n";
+        for (int i = 0; i < mResults.size(); ++i)
+        {
+            const Result& r = mResults[i];
+            ss << "    {\"count\": " << r.count << ", \"operation\": \"" << r.operation << "\""
+               << ", \"iterations\": " << r.iterations << ", \"total_ms\": " << r.totalMillis
+               << ", \"per_op_us\": " << r.totalMillis * 1000.0 / max(r.iterations, 1) << "}"
+               << (i + 1 < mResults.size() ? "," : "") << "\n";
+        }
+        ss << "  ]\n}\n";
+    }
+    else
+    {
+        ss << "count,width,height,visible,operation,iterations,total_ms,per_op_us\n";
+        for (const auto& r : mResults)
+        {
+            ss << r.count << "," << mSettings.width << "," << mSettings.height << "," << mSettings.visible << ","
+               << r.operation << "," << r.iterations << "," << r.totalMillis << ","
+               << r.totalMillis * 1000.0 / max(r.iterations, 1) << "\n";
+        }
+    }
+    
+    if (mSettings.output.empty())
+    {
+        cout << ss.str();
+    }
+    else
+    {
+        ofFile file(mSettings.output, ofFile::WriteOnly);
+        file << ss.str();
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxContentsManager.h"
+
+struct BenchmarkSettings
+{
+    vector<int> counts;
+    int         width;
+    int         height;
+    int         visible;
+    int         frames;
+    int         cpuIterations;
+    int         numRects;
+    bool        pool;
+    bool        compositor;
+    string      format;
+    string      output;
+    
+    BenchmarkSettings();
+    void parse(int argc, char* argv[]);
+};
+
+class ofApp : public ofBaseApp{
+    
+    struct Result
+    {
+        int     count;
+        string  operation;
+        int     iterations;
+        double  totalMillis;
+    };
+    
+    BenchmarkSettings   mSettings;
+    vector<Result>      mResults;
+    
+    void runBenchmark(const int count);
+    void addResult(const int count, const string& operation, const int iterations, const uint64_t micros);
+    void writeResults();
+    
+public:
+    ofApp(const BenchmarkSettings& settings) : mSettings(settings){}
+    
+    void setup();
+};
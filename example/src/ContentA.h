@@ -33,7 +33,7 @@ public:
         for(int i = 0; i < boxCount; i++) {
             ofPushMatrix();
             
-            float t = (ofGetElapsedTimef() + i * spacing) * movementSpeed;
+            float t = (getTime() + i * spacing) * movementSpeed;
             ofVec3f pos(
                         ofSignedNoise(t, 0, 0),
                         ofSignedNoise(0, t, 0),
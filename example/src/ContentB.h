@@ -33,7 +33,7 @@ public:
         cosine=0;
         sine=0;
         tangent=0;
-        rotationSpeed=0.01f;
+        rotationSpeed=0.6f; // radians per second
         radius = 180;
         center.set(ofGetWidth()*0.3f, ofGetHeight()*0.6f, 0);
         
@@ -44,9 +44,9 @@ public:
     
     void update()
     {
-        angle+=rotationSpeed;
+        angle+=rotationSpeed * getDeltaTime();
         if (angle>=TWO_PI) {
-            angle=0;
+            angle-=TWO_PI;
         }
         
         cosine=cos(angle);
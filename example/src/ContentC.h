@@ -20,7 +20,7 @@ public:
 
     void update()
     {
-        mCounter += ofGetLastFrameTime();
+        mCounter += getDeltaTime();
     }
     
     void draw()
@@ -28,8 +28,8 @@ public:
         ofPushMatrix();
         ofSetColor(255);
         ofTranslate(getWidth() * 0.5, getHeight() * 0.5);
-        ofRotateY(ofGetFrameNum() * 0.3);
-        ofRotateX(ofGetFrameNum() * 0.4);
+        ofRotateY(getFrameNum() * 0.3);
+        ofRotateX(getFrameNum() * 0.4);
         float s = 0;
         float t = 0;
         
@@ -15,6 +15,8 @@ void ofApp::setup(){
     gui.setName("FADERS");
     gui.add(mContentsManager.getOpacityParameterGroup());
     
+    bOfflineRender = false;
+    
     ofBackground(30);
 }
 
@@ -22,6 +24,14 @@ void ofApp::setup(){
 void ofApp::update(){
         
     mContentsManager.update();
+    
+    // back to display rate after offline rendering
+    if (bOfflineRender && !mContentsManager.isOfflineRendering())
+    {
+        ofSetVerticalSync(true);
+        ofSetFrameRate(60);
+        bOfflineRender = false;
+    }
 }
 
 //--------------------------------------------------------------
@@ -48,6 +58,14 @@ void ofApp::keyPressed(int key){
     // next or previous content
     if (key == OF_KEY_LEFT)  mContentsManager.switchPreviousContent();
     if (key == OF_KEY_RIGHT) mContentsManager.switchNextContent();
+    
+    // offline rendering, 10 seconds at 60fps into data/render/
+    if (key == 'o' && !bOfflineRender && mContentsManager.beginOfflineRender("render", 60, 600))
+    {
+        ofSetVerticalSync(false);
+        ofSetFrameRate(0);
+        bOfflineRender = true;
+    }
 }
 
 //--------------------------------------------------------------
@@ -24,6 +24,7 @@ public:
     
     
     ofxContentsManager::Manager mContentsManager;
+    bool bOfflineRender;
     
     ofxPanel gui;
     ofParameter<float> faderA;
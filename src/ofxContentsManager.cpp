@@ -1,7 +1,68 @@
 #include "ofxContentsManager.h"
+#include <typeindex>
 
 static const string MODULE_NAME = "ofxContentsManager";
 
+// fixed-step updates run per manager update at most, remaining time is dropped
+static const int MAX_UPDATE_STEPS = 4;
+
+namespace
+{
+    ofTexture& getTexture(ofFbo& fbo)
+    {
+#if (OF_VERSION_MAJOR == 0 && OF_VERSION_MINOR < 9)
+        return fbo.getTextureReference();
+#else
+        return fbo.getTexture();
+#endif
+    }
+    
+    float ease(const ofxContentsManager::Easing easing, const float t)
+    {
+        switch (easing)
+        {
+            case ofxContentsManager::EASE_IN_QUAD:      return t * t;
+            case ofxContentsManager::EASE_OUT_QUAD:     return t * (2 - t);
+            case ofxContentsManager::EASE_IN_OUT_QUAD:  return t < 0.5 ? 2 * t * t : -1 + (4 - 2 * t) * t;
+            case ofxContentsManager::EASE_IN_OUT_CUBIC: return t < 0.5 ? 4 * t * t * t : (t - 1) * (2 * t - 2) * (2 * t - 2) + 1;
+            case ofxContentsManager::EASE_IN_OUT_SINE:  return 0.5 - 0.5 * cos(t * PI);
+            default:                                    return t;
+        }
+    }
+}
+
+namespace
+{
+    // demangled class names, resolved once per type
+    const string& getDemangledName(const type_info& id)
+    {
+        static unordered_map<type_index, string> cache;
+        static mutex cacheMutex;
+        
+        lock_guard<mutex> lock(cacheMutex);
+        unordered_map<type_index, string>::iterator it = cache.find(type_index(id));
+        if (it != cache.end()) return it->second;
+        
+        string result;
+        int stat;
+        char *name = abi::__cxa_demangle(id.name(), 0, 0, &stat);
+        if (name != NULL && stat == 0) {
+            result = name;
+        }
+        else {
+            ofLogWarning(MODULE_NAME) << "faild get object name";
+        }
+        free(name);
+        return cache.insert(make_pair(type_index(id), result)).first->second;
+    }
+    
+    bool isInside(const ofRectangle& inner, const ofRectangle& outer)
+    {
+        return inner.getLeft() >= outer.getLeft() && inner.getRight() <= outer.getRight()
+            && inner.getTop() >= outer.getTop() && inner.getBottom() <= outer.getBottom();
+    }
+}
+
 namespace ofxContentsManager
 {
     
@@ -13,26 +74,76 @@ namespace ofxContentsManager
     
     void Content::setName(const string &name)
     {
-        contentName = name;
+        if (parentManager)
+        {
+            const string oldName = getName();
+            contentName = name;
+            parentManager->renameContent(this, oldName, getName());
+        }
+        else contentName = name;
+    }
+    
+    
+    void Content::setResolutionScale(float scale)
+    {
+        resolutionScale = max(scale, 0.01f);
+        if (parentManager) parentManager->reallocateContent(this);
+    }
+    
+    void Content::setRenderSize(int width, int height)
+    {
+        renderWidth = max(width, 0);
+        renderHeight = max(height, 0);
+        if (parentManager) parentManager->reallocateContent(this);
+    }
+    
+    void Content::setUpsampleFilter(GLint filter)
+    {
+        upsampleFilter = filter;
+        if (parentManager) parentManager->applyUpsampleFilter(this);
+    }
+    
+    void Content::setRegion(const ofRectangle& rect)
+    {
+        region = rect;
+        if (parentManager) parentManager->resizeContent(this);
+    }
+    
+    int Content::getRenderWidth() const
+    {
+        return renderWidth > 0 ? renderWidth : max((int)roundf(bufferWidth * resolutionScale), 1);
     }
     
+    int Content::getRenderHeight() const
+    {
+        return renderHeight > 0 ? renderHeight : max((int)roundf(bufferHeight * resolutionScale), 1);
+    }
     
-    string Content::getName()
+    const string& Content::getName()
     {
         if (contentName.empty())
         {
-            const type_info& id = typeid(*this);
-            int stat;
-            char *name = abi::__cxa_demangle(id.name(), 0, 0, &stat);
-            if (name != NULL && stat == 0) {
-                return string(name);
-            }
-            ofLogWarning(MODULE_NAME) << "faild get object name";
-            return "";
+            return getDemangledName(typeid(*this));
         }
         else return contentName;
     }
     
+    float Content::getTime() const
+    {
+        return parentManager ? parentManager->mTime : ofGetElapsedTimef();
+    }
+    
+    float Content::getDeltaTime() const
+    {
+        if (updateInterval > 0) return updateInterval;
+        return parentManager ? parentManager->mDeltaTime : ofGetLastFrameTime();
+    }
+    
+    uint64_t Content::getFrameNum() const
+    {
+        return parentManager ? parentManager->mFrameNum : ofGetFrameNum();
+    }
+    
     
     
     //---------------------------------------------------------------------------------------
@@ -51,68 +162,968 @@ namespace ofxContentsManager
         return true;
     }
     
+    bool Manager::isValid(const string& name)
+    {
+        if (mNameIndex.find(name) == mNameIndex.end())
+        {
+            ofLogError(MODULE_NAME) << "Manager has not content's name: " << name;
+            return false;
+        }
+        return true;
+    }
+    
+    Manager::myContent* Manager::resolve(const ContentHandle& handle)
+    {
+        myContent* o = lookup(handle);
+        if (o == NULL) ofLogError(MODULE_NAME) << "Manager has not content's handle: " << handle.slot << ":" << handle.generation;
+        return o;
+    }
+    
+    Manager::myContent* Manager::lookup(const ContentHandle& handle)
+    {
+        return contains(handle) ? mSlots[handle.slot].o : NULL;
+    }
+    
+    void Manager::acquireSlot(myContent* o)
+    {
+        if (mFreeSlots.empty())
+        {
+            mySlot slot = { NULL, 1 };
+            mSlots.push_back(slot);
+            o->slot = mSlots.size() - 1;
+        }
+        else
+        {
+            o->slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+        mSlots[o->slot].o = o;
+        o->obj->handle = ContentHandle(o->slot, mSlots[o->slot].generation);
+    }
+    
+    void Manager::releaseSlot(myContent* o)
+    {
+        mySlot& slot = mSlots[o->slot];
+        slot.o = NULL;
+        if (++slot.generation == 0) slot.generation = 1; // 0 is null handle
+        mFreeSlots.push_back(o->slot);
+        o->obj->handle = ContentHandle();
+    }
+    
+    Manager::myContent* Manager::findContent(Content* obj)
+    {
+        // O(1) by the content's own handle, which may belong to another manager
+        myContent* o = lookup(obj->handle);
+        return o && o->obj == obj ? o : NULL;
+    }
+    
+    void Manager::renameContent(Content* obj, const string& oldName, const string& newName)
+    {
+        pair<name_index_it, name_index_it> range = mNameIndex.equal_range(oldName);
+        for (name_index_it it = range.first; it != range.second; ++it)
+        {
+            if (it->second->obj == obj)
+            {
+                myContent* o = it->second;
+                mNameIndex.erase(it);
+                mNameIndex.insert(make_pair(newName, o));
+                return;
+            }
+        }
+    }
+    
+    void Manager::destroyContent(myContent* o)
+    {
+        mLoader.cancel(o->obj);
+        mSetupQueue.erase(remove(mSetupQueue.begin(), mSetupQueue.end(), o), mSetupQueue.end());
+        if (mPendingSwitch.o == o) mPendingSwitch.active = false;
+        if (o->bOpacityDirty) mOpacityDirty.erase(remove(mOpacityDirty.begin(), mOpacityDirty.end(), o), mOpacityDirty.end());
+        replace(mOpacityNotifying.begin(), mOpacityNotifying.end(), o, (myContent*)NULL); // may be in notifyOpacity() loop
+        pair<name_index_it, name_index_it> range = mNameIndex.equal_range(o->obj->getName());
+        for (name_index_it it = range.first; it != range.second; ++it)
+        {
+            if (it->second == o)
+            {
+                mNameIndex.erase(it);
+                break;
+            }
+        }
+        o->obj->exit();
+        o->obj->parentManager = NULL;
+        for (auto& output : mOutputs)
+        {
+            output->removeLayer(o->obj->handle);
+            output->clearOpacity(o->obj->handle);
+        }
+        releaseSlot(o);
+        cancelTransition(o);
+        mPrewarmQueue.erase(remove(mPrewarmQueue.begin(), mPrewarmQueue.end(), o), mPrewarmQueue.end());
+        freeContent(o);
+    }
+    
+    void Manager::freeContent(myContent* o)
+    {
+        // copies of the parameter (e.g. in a GUI) outlive the content
+        o->opacity.removeListener(o, &myContent::onOpacityChanged);
+        o->opacity.removeListener(o->obj, &Content::onOpacityChanged);
+        releaseBuffer(o);
+        if (o->objMemory)
+        {
+            o->obj->~Content();
+            mArena.deallocate(o->objMemory, o->objSize, o->objAlignment);
+        }
+        else delete o->obj;
+        o->~myContent();
+        mArena.deallocate(o, sizeof(myContent), alignof(myContent));
+    }
+    
+    void Manager::eraseContent(const int index)
+    {
+        type_bucket& bucket = mTypeIndex[mTypeIDs[index]];
+        bucket.erase(find(bucket.begin(), bucket.end(), mContents[index]));
+        destroyContent(mContents[index]);
+        mContents.erase(mContents.begin() + index);
+        mOpacities.erase(mOpacities.begin() + index);
+        mFlags.erase(mFlags.begin() + index);
+        mTypeIDs.erase(mTypeIDs.begin() + index);
+        mFbos.erase(mFbos.begin() + index);
+        for (int i = index; i < mContents.size(); ++i)
+        {
+            mContents[i]->index = i;
+        }
+        
+        vector<int>::iterator it = lower_bound(mVisible.begin(), mVisible.end(), index);
+        if (it != mVisible.end() && *it == index) it = mVisible.erase(it);
+        for (; it != mVisible.end(); ++it)
+        {
+            --(*it);
+        }
+    }
+    
+    void Manager::syncOpacity(myContent* o)
+    {
+        const int i = o->index;
+        mOpacities[i] = o->opacity;
+        const bool visible = mOpacities[i] > 0.0;
+        if (visible == ((mFlags[i] & FLAG_VISIBLE) != 0)) return;
+        
+        vector<int>::iterator it = lower_bound(mVisible.begin(), mVisible.end(), i);
+        if (visible)
+        {
+            mFlags[i] |= FLAG_VISIBLE;
+            mVisible.insert(it, i);
+            return;
+        }
+        
+        mFlags[i] &= ~(FLAG_VISIBLE | FLAG_OCCLUDED);
+        mVisible.erase(it);
+        if (!bBackgroundUpdate && !(mFlags[i] & FLAG_OUTPUT)) suspendContent(o);
+    }
+    
+    void Manager::suspendContent(myContent* o)
+    {
+        // hidden contents are not updated, restart scheduling when becoming visible again
+        o->obj->nextRenderTime = -1;
+        o->obj->lastUpdateTime = -1;
+        if (bFboPool) releaseBuffer(o);
+    }
+    
+    void Manager::writeOpacity(myContent* o, const float opacity)
+    {
+        o->opacity.setWithoutEventNotifications(opacity);
+        syncOpacity(o);
+        if (!o->bOpacityDirty)
+        {
+            o->bOpacityDirty = true;
+            mOpacityDirty.push_back(o);
+        }
+    }
+    
+    void Manager::notifyOpacity()
+    {
+        // listeners may write opacities again, those are notified in next update()
+        mOpacityNotifying.swap(mOpacityDirty);
+        // listeners may remove contents, removed ones are set to NULL
+        for (size_t k = 0; k < mOpacityNotifying.size(); ++k)
+        {
+            myContent* o = mOpacityNotifying[k];
+            if (o == NULL) continue;
+            o->bOpacityDirty = false;
+            if (o->opacity != o->notifiedOpacity) o->opacity = o->opacity.get();
+        }
+        mOpacityNotifying.clear();
+    }
+    
+    void Manager::setContentState(myContent* o, const ContentState newState)
+    {
+        o->obj->state = newState;
+        if (newState == CONTENT_READY) mFlags[o->index] |= FLAG_READY;
+        else mFlags[o->index] &= ~FLAG_READY;
+    }
+    
+    void Manager::allocateContentBuffer(myContent* o)
+    {
+        ofFbo::Settings settings = mFboSettings;
+        settings.width = o->obj->getRenderWidth();
+        settings.height = o->obj->getRenderHeight();
+        ofFbo*& fbo = mFbos[o->index];
+        if (fbo == NULL) fbo = new ofFbo();
+        fbo->allocate(settings);
+        getTexture(*fbo).setTextureMinMagFilter(o->obj->upsampleFilter, o->obj->upsampleFilter);
+        o->obj->bInvalidated = true;
+        o->obj->nextRenderTime = -1; // render the new buffer before it is composited
+    }
+    
+    void Manager::reallocateContent(Content* obj)
+    {
+        myContent* o = findContent(obj);
+        if (o == NULL) return;
+        if (bFboPool) releaseBuffer(o); // leased again at the new size
+        else if (!isFlattened(o)) allocateContentBuffer(o);
+    }
+    
+    void Manager::applyUpsampleFilter(Content* obj)
+    {
+        // sampling state only, the frame buffer and its pixels are kept
+        myContent* o = findContent(obj);
+        if (o == NULL || mFbos[o->index] == NULL) return;
+        getTexture(*mFbos[o->index]).setTextureMinMagFilter(obj->upsampleFilter, obj->upsampleFilter);
+    }
+    
+    void Manager::resizeContent(Content* obj)
+    {
+        applyBufferSize(obj);
+        reallocateContent(obj);
+        obj->bufferResized(obj->bufferWidth, obj->bufferHeight);
+    }
+    
+    void Manager::applyBufferSize(Content* obj)
+    {
+        obj->bufferWidth  = obj->region.isEmpty() ? mFboSettings.width  : obj->region.width;
+        obj->bufferHeight = obj->region.isEmpty() ? mFboSettings.height : obj->region.height;
+    }
+    
+    bool Manager::acquireBuffer(myContent* o)
+    {
+        ofFbo*& fbo = mFbos[o->index];
+        if (fbo) return true;
+        if (!bFboPool)
+        {
+            // released while the content was flattened
+            allocateContentBuffer(o);
+            return true;
+        }
+        fbo = mFboPool.acquire(o->obj->getRenderWidth(), o->obj->getRenderHeight());
+        if (fbo == NULL)
+        {
+            if (!bFboPoolExhausted) ofLogWarning(MODULE_NAME) << "frame buffer pool is exhausted, skip rendering: " << o->obj->getName();
+            bFboPoolExhausted = true;
+            bFboPoolFailed = true;
+            return false;
+        }
+        getTexture(*fbo).setTextureMinMagFilter(o->obj->upsampleFilter, o->obj->upsampleFilter);
+        o->obj->bInvalidated = true; // leased frame buffer holds other content's pixels
+        o->obj->nextRenderTime = -1;
+        return true;
+    }
+    
+    void Manager::releaseBuffer(myContent* o)
+    {
+        ofFbo*& fbo = mFbos[o->index];
+        if (fbo == NULL) return;
+        if (bFboPool) mFboPool.release(fbo);
+        else delete fbo;
+        fbo = NULL;
+    }
+    
     Manager::Manager()
     : bBackgroundUpdate(false)
+    , bScheduledBackgroundUpdate(false)
+    , mBackgroundBudget(2)
     , mCurrentContent(0)
+    , bFboPool(false)
+    , bFboPoolExhausted(false)
+    , bFboPoolFailed(false)
+    , bCompositor(false)
+    , mCompositeZ(0)
+    , bPassThrough(false)
+    , bUpdateThreads(false)
+    , mUpdateTime(0)
+    , bOpacityBatch(false)
+    , bAsyncLoading(false)
+    , mSetupBudget(4)
+    , mPrewarmBudget(4)
+    , mTransitionStart(0)
+    , mTransitionDuration(0)
+    , mTransitionEasing(EASE_LINEAR)
+    , mClockMode(CLOCK_MODE_REALTIME)
+    , mClockStep(1.0 / 60)
+    , mTime(0)
+    , mDeltaTime(0)
+    , mFrameNum(0)
+    , bClockStarted(false)
+    , bReadback(false)
+    , bOfflineRender(false)
+    , bOfflineReadback(false)
+    , bOfflineDropFrames(true)
+    , mOfflineFirstFrame(0)
+    , mOfflineNumFrames(0)
+    , mOfflineClockMode(CLOCK_MODE_REALTIME)
+    , mOfflineClockStep(1.0 / 60)
+    , bOcclusionCulling(false)
+    , bUpdateOccluded(false)
+    , bProfiler(false)
+    {
+        mThreadedUpdateTask = [this](int i){ updateContent(mThreadedUpdates[i], mUpdateTime); };
+        mPendingSwitch.active = false;
+        mPendingSwitch.o = NULL;
+        state = CONTENT_READY;
+    }
+    
+    Manager::~Manager()
+    {
+        if (bOfflineRender) endOfflineRender();
+        mLoader.close();
+        for (auto& output : mOutputs)
+        {
+            delete output;
+        }
+        // contents in the arena are destroyed before the arena, exit() is up to Manager::exit()
+        for (auto& o : mContents)
+        {
+            o->obj->parentManager = NULL;
+            freeContent(o);
+        }
+    };
+    
+    void Manager::setup(const float width, const float height, const int internalformat, const int numSamples)
+    {
+        mFboSettings = ofFbo::Settings();
+        mFboSettings.width = width;
+        mFboSettings.height = height;
+        mFboSettings.internalformat = internalformat;
+        mFboSettings.numSamples = numSamples;
+        if (bFboPool) allocatePool();
+    }
+    
+    void Manager::setup(const ofFbo::Settings& settings)
+    {
+        mFboSettings = settings;
+        if (bFboPool) allocatePool();
+    }
+    
+    void Manager::update()
+    {
+        updateClock();
+        const float time = mTime;
+        mUpdateTime = time;
+        
+        updateLoading();
+        if (!mTransitionLayers.empty()) updateTransition(time);
+        if (!mOpacityDirty.empty() && !bOpacityBatch) notifyOpacity();
+        if (!mOutputs.empty() || !mOutputShown.empty()) updateOutputs();
+        if (bOcclusionCulling) updateOcclusion();
+        
+        // copied, contents may change opacities in their update()
+        if (bBackgroundUpdate)
+        {
+            mUpdateOrder.resize(mContents.size());
+            for (int i = 0; i < mUpdateOrder.size(); ++i) mUpdateOrder[i] = i;
+        }
+        else
+        {
+            mUpdateOrder = mVisible;
+            
+            // hidden in the manager but shown in outputs
+            const size_t numVisible = mUpdateOrder.size();
+            for (const auto& handle : mOutputShown)
+            {
+                myContent* o = lookup(handle);
+                if (o && !(mFlags[o->index] & FLAG_VISIBLE)) mUpdateOrder.push_back(o->index);
+            }
+            if (mUpdateOrder.size() > numVisible) sort(mUpdateOrder.begin(), mUpdateOrder.end());
+        }
+        const uint8_t shown = bBackgroundUpdate ? FLAG_READY : FLAG_VISIBLE | FLAG_OUTPUT;
+        
+        // parallel phase, GL-free updates
+        mThreadedUpdates.clear();
+        if (bUpdateThreads)
+        {
+            for (const int i : mUpdateOrder)
+            {
+                if ((mFlags[i] & FLAG_READY) && (mFlags[i] & shown) && mContents[i]->obj->bThreadSafeUpdate
+                    && (bUpdateOccluded || (mFlags[i] & (FLAG_OCCLUDED | FLAG_OUTPUT)) != FLAG_OCCLUDED))
+                {
+                    mThreadedUpdates.push_back(mContents[i]);
+                }
+            }
+            mWorkerPool.parallelFor(mThreadedUpdates.size(), mThreadedUpdateTask);
+        }
+        
+        // serial phase, remaining updates and render
+        for (int k = 0; k < mUpdateOrder.size(); ++k)
+        {
+            const int i = mUpdateOrder[k];
+            if (i >= mContents.size() || !(mFlags[i] & FLAG_READY) || !(mFlags[i] & shown)) continue;
+            myContent* e = mContents[i];
+            const bool occluded = (mFlags[i] & (FLAG_OCCLUDED | FLAG_OUTPUT)) == FLAG_OCCLUDED;
+            if (occluded && !bUpdateOccluded) continue;
+            
+            if (!bUpdateThreads || !e->obj->bThreadSafeUpdate) updateContent(e, time);
+            
+            if (occluded) continue;
+            if (isFlattened(e))
+            {
+                // layers are composited by this manager, no intermediate buffer
+                releaseBuffer(e);
+                warmContent(e);
+                continue;
+            }
+            if (!acquireBuffer(e)) continue;
+            if (!isRenderDue(e, time)) continue;
+            if (e->obj->bRenderCache && !e->obj->bInvalidated && !e->obj->isOutputChanged()) continue;
+            renderContent(e);
+        }
+        
+        if (bScheduledBackgroundUpdate && !bBackgroundUpdate) updateBackground(time);
+        if (!mPrewarmQueue.empty()) updatePrewarm();
+        if (!mOutputs.empty()) compositeOutputs();
+        if (bReadback) compositeOutput();
+        if (bProfiler) updateProfiler();
+        
+        // warn again only after the pool has recovered
+        if (!bFboPoolFailed) bFboPoolExhausted = false;
+        bFboPoolFailed = false;
+        
+        if (bOfflineRender && mOfflineNumFrames > 0 && mReadback.getNumRequested() - mOfflineFirstFrame >= mOfflineNumFrames)
+        {
+            endOfflineRender();
+        }
+    }
+    
+    void Manager::updateClock()
+    {
+        // nested managers share the parent's clock
+        if (parentManager)
+        {
+            mTime = parentManager->mTime;
+            mDeltaTime = parentManager->mDeltaTime;
+            mFrameNum = parentManager->mFrameNum;
+            return;
+        }
+        
+        if (bClockStarted) ++mFrameNum;
+        if (mClockMode == CLOCK_MODE_FIXED_STEP)
+        {
+            mDeltaTime = bClockStarted ? mClockStep : 0;
+            mTime = mFrameNum * mClockStep;
+        }
+        else
+        {
+            const float time = ofGetElapsedTimef();
+            mDeltaTime = bClockStarted ? time - mTime : 0;
+            mTime = time;
+        }
+        bClockStarted = true;
+    }
+    
+    void Manager::rebaseClock(const float time)
+    {
+        // shift pending timings so render rates, update rates and transitions continue
+        const float offset = time - mTime;
+        mTransitionStart += offset;
+        for (auto& o : mContents)
+        {
+            Content* c = o->obj;
+            c->serviceTime += offset;
+            if (c->lastUpdateTime >= 0) c->lastUpdateTime += offset;
+            if (c->nextRenderTime >= 0) c->nextRenderTime += offset;
+        }
+        mTime = time;
+    }
+    
+    void Manager::updateBackground(const float time)
+    {
+        mBackgroundQueue.clear();
+        for (int i = 0; i < mContents.size(); ++i)
+        {
+            // ready and hidden
+            if (mFlags[i] == FLAG_READY && mContents[i]->obj->backgroundPriority > 0) mBackgroundQueue.push_back(mContents[i]);
+        }
+        if (mBackgroundQueue.empty()) return;
+        
+        sort(mBackgroundQueue.begin(), mBackgroundQueue.end(), [time](const myContent* a, const myContent* b) {
+            return (time - a->obj->serviceTime) * a->obj->backgroundPriority > (time - b->obj->serviceTime) * b->obj->backgroundPriority;
+        });
+        
+        const uint64_t start = ofGetElapsedTimeMicros();
+        for (const auto& e : mBackgroundQueue)
+        {
+            updateContent(e, time);
+            
+            // pooled frame buffers are kept for visible contents
+            if (!bFboPool && mFbos[e->index] && (!e->obj->bRenderCache || e->obj->bInvalidated || e->obj->isOutputChanged()))
+            {
+                renderContent(e);
+            }
+            if ((ofGetElapsedTimeMicros() - start) / 1000.0 >= mBackgroundBudget) break;
+        }
+    }
+    
+    void Manager::startLoading(myContent* o)
+    {
+        if (bAsyncLoading)
+        {
+            setContentState(o, CONTENT_LOADING);
+            mLoader.push(o->obj);
+            return;
+        }
+        
+        setContentState(o, o->obj->load() && o->obj->setupGL() ? CONTENT_READY : CONTENT_FAILED);
+        if (o->obj->state == CONTENT_FAILED)
+        {
+            ofLogError(MODULE_NAME) << "failed to load content: " << o->obj->getName();
+        }
+    }
+    
+    void Manager::updateLoading()
+    {
+        Content* obj;
+        bool succeed;
+        while (mLoader.pop(obj, succeed))
+        {
+            myContent* o = findContent(obj);
+            if (o == NULL) continue;
+            if (succeed)
+            {
+                mSetupQueue.push_back(o);
+            }
+            else
+            {
+                setContentState(o, CONTENT_FAILED);
+                ofLogError(MODULE_NAME) << "failed to load content: " << obj->getName();
+            }
+        }
+        
+        const uint64_t start = ofGetElapsedTimeMicros();
+        while (!mSetupQueue.empty())
+        {
+            myContent* o = mSetupQueue.front();
+            mSetupQueue.pop_front();
+            setContentState(o, o->obj->setupGL() ? CONTENT_READY : CONTENT_FAILED);
+            if (o->obj->state == CONTENT_FAILED)
+            {
+                ofLogError(MODULE_NAME) << "failed to setup content: " << o->obj->getName();
+            }
+            if ((ofGetElapsedTimeMicros() - start) / 1000.0 >= mSetupBudget) break;
+        }
+        
+        if (mPendingSwitch.active) updatePendingSwitch();
+    }
+    
+    void Manager::updatePendingSwitch()
+    {
+        if (mPendingSwitch.byName)
+        {
+            pair<name_index_it, name_index_it> range = mNameIndex.equal_range(mPendingSwitch.name);
+            for (name_index_it it = range.first; it != range.second; ++it)
+            {
+                if (it->second->obj->state == CONTENT_LOADING) return;
+            }
+            mPendingSwitch.active = false;
+            switchContent(mPendingSwitch.name, mPendingSwitch.duration, mPendingSwitch.easing);
+        }
+        else
+        {
+            if (mPendingSwitch.o->obj->state == CONTENT_LOADING) return;
+            mPendingSwitch.active = false;
+            switchContent(mPendingSwitch.o->index, mPendingSwitch.duration, mPendingSwitch.easing);
+        }
+    }
+    
+    void Manager::updatePrewarm()
+    {
+        const uint64_t start = ofGetElapsedTimeMicros();
+        int numSkipped = 0;
+        do
+        {
+            myContent* o = mPrewarmQueue.front();
+            if (o->obj->bWarm || o->obj->state == CONTENT_FAILED)
+            {
+                mPrewarmQueue.pop_front();
+                continue;
+            }
+            if (o->obj->state == CONTENT_LOADING)
+            {
+                // wait for loading, try the others first
+                mPrewarmQueue.pop_front();
+                mPrewarmQueue.push_back(o);
+                if (++numSkipped >= mPrewarmQueue.size()) return;
+                continue;
+            }
+            if (isFlattened(o))
+            {
+                // the group renders its visible layers in its update(), hidden members are warmed by its own prewarm queue
+                if (o->group->getNumPendingPrewarm() == 0) o->group->prewarmAll();
+                mPrewarmQueue.pop_front();
+                updateContent(o, mUpdateTime);
+                if (o->group->getNumPendingPrewarm() > 0)
+                {
+                    // members left for the next update, try the others first
+                    mPrewarmQueue.push_back(o);
+                    if (!(mFlags[o->index] & (FLAG_VISIBLE | FLAG_OUTPUT)) && !bBackgroundUpdate) suspendContent(o);
+                    return;
+                }
+                warmContent(o);
+            }
+            else
+            {
+                if (!acquireBuffer(o)) return; // pool exhausted, retry next update
+                mPrewarmQueue.pop_front();
+                updateContent(o, mUpdateTime);
+                renderContent(o);
+            }
+            
+            if (!(mFlags[o->index] & (FLAG_VISIBLE | FLAG_OUTPUT)) && !bBackgroundUpdate) suspendContent(o);
+        }
+        while (!mPrewarmQueue.empty() && (ofGetElapsedTimeMicros() - start) / 1000.0 < mPrewarmBudget);
+    }
+    
+    void Manager::updateContent(myContent* o, const float time)
+    {
+        Content* c = o->obj;
+        const uint64_t start = ofGetElapsedTimeMicros();
+        c->serviceTime = time;
+        if (c->updateInterval <= 0)
+        {
+            c->update();
+            c->updateDuration = (ofGetElapsedTimeMicros() - start) / 1000.0;
+#if OFX_CONTENTS_MANAGER_PROFILER
+            if (bProfiler) o->updateTimer.add(c->updateDuration);
+#endif
+            return;
+        }
+        
+        if (c->lastUpdateTime < 0) c->updateAccumulator = c->updateInterval;
+        else c->updateAccumulator += time - c->lastUpdateTime;
+        c->lastUpdateTime = time;
+        
+        int steps = 0;
+        while (c->updateAccumulator >= c->updateInterval && steps < MAX_UPDATE_STEPS)
+        {
+            c->update();
+            c->updateAccumulator -= c->updateInterval;
+            ++steps;
+        }
+        if (steps == MAX_UPDATE_STEPS) c->updateAccumulator = fmod(c->updateAccumulator, c->updateInterval);
+        c->updateDuration = (ofGetElapsedTimeMicros() - start) / 1000.0;
+#if OFX_CONTENTS_MANAGER_PROFILER
+        if (bProfiler) o->updateTimer.add(c->updateDuration);
+#endif
+    }
+    
+    bool Manager::isRenderDue(myContent* o, const float time)
+    {
+        Content* c = o->obj;
+        if (c->renderInterval <= 0) return true;
+        
+        if (c->nextRenderTime < 0)
+        {
+            c->nextRenderTime = time + c->renderInterval;
+            return true;
+        }
+        if (time < c->nextRenderTime) return false;
+        
+        const int missed = (time - c->nextRenderTime) / c->renderInterval;
+        c->nextRenderTime += (missed + 1) * c->renderInterval;
+        if (missed > 0)
+        {
+            c->numMissedRenders += missed;
+            c->renderMissed(missed);
+        }
+        return true;
+    }
+    
+    void Manager::renderContent(myContent* o)
+    {
+#if OFX_CONTENTS_MANAGER_PROFILER
+        const uint64_t start = ofGetElapsedTimeMicros();
+        if (bProfiler) o->gpuTimer.begin();
+#endif
+        ofFbo* fbo = mFbos[o->index];
+        mStateGuard.save(o->obj->stateIsolation);
+        fbo->begin();
+        ofClear(0);
+        ofPushMatrix();
+        ofPushStyle();
+        if (fbo->getWidth() != o->obj->bufferWidth || fbo->getHeight() != o->obj->bufferHeight)
+        {
+            // draw in logical size
+            ofScale(fbo->getWidth() / o->obj->bufferWidth, fbo->getHeight() / o->obj->bufferHeight);
+        }
+        o->obj->draw();
+        ofPopStyle();
+        ofPopMatrix();
+        fbo->end();
+        mStateGuard.restore();
+        warmContent(o);
+#if OFX_CONTENTS_MANAGER_PROFILER
+        if (bProfiler)
+        {
+            o->gpuTimer.end();
+            o->drawTimer.add((ofGetElapsedTimeMicros() - start) / 1000.0);
+        }
+#endif
+        o->obj->bInvalidated = false;
+    }
+    
+    void Manager::warmContent(myContent* o)
+    {
+        if (o->obj->bWarm) return;
+        o->obj->bWarm = true;
+        o->obj->warmed();
+    }
+    
+    ofRectangle Manager::getContentRect(myContent* o)
+    {
+        if (o->obj->region.isEmpty()) return ofRectangle(0, 0, mFboSettings.width, mFboSettings.height);
+        return o->obj->region;
+    }
+    
+    void Manager::updateOcclusion()
+    {
+        // from the top layer, a layer is hidden when an opaque layer above covers it
+        mOccluders.clear();
+        for (int k = mVisible.size() - 1; k >= 0; --k)
+        {
+            const int i = mVisible[k];
+            bool occluded = false;
+            const ofRectangle rect = getContentRect(mContents[i]);
+            for (const auto& occluder : mOccluders)
+            {
+                if (isInside(rect, occluder)) { occluded = true; break; }
+            }
+            if (occluded)
+            {
+                mFlags[i] |= FLAG_OCCLUDED;
+                continue;
+            }
+            mFlags[i] &= ~FLAG_OCCLUDED;
+            
+            // rendered at least once, so its frame buffer can stand in for the layers beneath
+            Content* c = mContents[i]->obj;
+            if (c->bOpaque && mOpacities[i] >= 1.0 && (mFlags[i] & FLAG_READY) && mFbos[i] && c->bWarm)
+            {
+                if (c->opaqueRect.isEmpty()) mOccluders.push_back(rect);
+                else mOccluders.push_back(ofRectangle(rect.x + c->opaqueRect.x, rect.y + c->opaqueRect.y, c->opaqueRect.width, c->opaqueRect.height));
+            }
+        }
+    }
+    
+    void Manager::draw(const float x, const float y, const float z, const float width, const float height)
+    {
+        if (bReadback)
+        {
+            // composited in update()
+            getTexture(mOutputFbo).draw(x, y, z, width, height);
+            return;
+        }
+        drawComposite(x, y, z, width, height);
+    }
+    
+    void Manager::compositeOutput()
+    {
+        mOutputFbo.begin();
+        ofClear(0);
+        ofPushStyle();
+        ofSetColor(255);
+        drawComposite(0, 0, 0, mFboSettings.width, mFboSettings.height);
+        ofPopStyle();
+        mOutputFbo.end();
+        mReadback.read(mOutputFbo);
+    }
+    
+    void Manager::drawComposite(const float x, const float y, const float z, const float width, const float height)
+    {
+#if OFX_CONTENTS_MANAGER_PROFILER
+        if (bProfiler)
+        {
+            const uint64_t start = ofGetElapsedTimeMicros();
+            mCompositeGpuTimer.begin();
+            compositeContents(x, y, z, width, height);
+            mCompositeGpuTimer.end();
+            mCompositeTimer.add((ofGetElapsedTimeMicros() - start) / 1000.0);
+            return;
+        }
+#endif
+        compositeContents(x, y, z, width, height);
+    }
+    
+    void Manager::compositeContents(const float x, const float y, const float z, const float width, const float height)
+    {
+        if (bOcclusionCulling) updateOcclusion(); // opacities may be changed after update()
+        compositeLayers(mVisible, mOpacities, true, x, y, z, width, height);
+    }
+    
+    void Manager::compositeLayers(const vector<int>& layers, const vector<float>& opacities, const bool culling, const float x, const float y, const float z, const float width, const float height)
     {
+        mCompositeRect.set(x, y, width, height);
+        mCompositeZ = z;
+        mVisibleTextures.clear();
+        mVisibleOpacities.clear();
+        collectLayers(this, layers, opacities, 1.0, culling, ofGetStyle().color, x, y, z, width, height, bCompositor);
+        if (bCompositor) flushLayers();
     }
     
-    Manager::~Manager()
+    void Manager::collectLayers(Manager* target, const vector<int>& layers, const vector<float>& opacities, const float groupOpacity, const bool culling, const ofColor& color, const float x, const float y, const float z, const float width, const float height, const bool batch)
     {
-    };
+        const uint8_t hidden = culling ? FLAG_OCCLUDED : 0;
+        for (const int i : layers)
+        {
+            if ((mFlags[i] & (FLAG_READY | hidden)) != FLAG_READY || opacities[i] <= 0.0) continue;
+            const float opacity = opacities[i] * groupOpacity;
+            myContent* o = mContents[i];
+            
+            if (isFlattened(o))
+            {
+                // the group's layers go into the target directly, in the group's rectangle
+                Manager* group = o->group;
+                if (group->bOcclusionCulling) group->updateOcclusion();
+                const ofRectangle& region = o->obj->region;
+                if (region.isEmpty())
+                {
+                    group->collectLayers(target, group->mVisible, group->mOpacities, opacity, true, color, x, y, z, width, height, batch);
+                    continue;
+                }
+                const float sx = width / mFboSettings.width;
+                const float sy = height / mFboSettings.height;
+                group->collectLayers(target, group->mVisible, group->mOpacities, opacity, true, color, x + region.x * sx, y + region.y * sy, z, region.width * sx, region.height * sy, false);
+                continue;
+            }
+            
+            if (!mFbos[i]) continue;
+            if (batch && o->obj->region.isEmpty())
+            {
+                target->mVisibleTextures.push_back(&getTexture(*mFbos[i]));
+                target->mVisibleOpacities.push_back(opacity);
+                continue;
+            }
+            
+            // placed contents are drawn alone in their rectangle, blend the layers beneath first
+            if (target->bCompositor) target->flushLayers();
+            drawContent(i, opacity, color, x, y, z, width, height);
+        }
+    }
     
-    void Manager::setup(const float width, const float height, const int internalformat, const int numSamples)
+    void Manager::flushLayers()
     {
-        mFboSettings = ofFbo::Settings();
-        mFboSettings.width = width;
-        mFboSettings.height = height;
-        mFboSettings.internalformat = internalformat;
-        mFboSettings.numSamples = numSamples;
+        mCompositor.draw(mVisibleTextures, mVisibleOpacities, mCompositeRect.x, mCompositeRect.y, mCompositeZ, mCompositeRect.width, mCompositeRect.height);
+        mVisibleTextures.clear();
+        mVisibleOpacities.clear();
     }
     
-    void Manager::setup(const ofFbo::Settings& settings)
+    void Manager::drawContent(const int index, const float opacity, const ofColor& color, const float x, const float y, const float z, const float width, const float height)
     {
-        mFboSettings = settings;
+        const ofRectangle& region = mContents[index]->obj->region;
+        ofPushStyle();
+        ofSetColor(color, opacity * color.a);
+        if (region.isEmpty())
+        {
+            getTexture(*mFbos[index]).draw(x, y, z, width, height);
+        }
+        else
+        {
+            // quad of the rectangle only, fill-rate is proportional to the area
+            const float sx = width / mFboSettings.width;
+            const float sy = height / mFboSettings.height;
+            getTexture(*mFbos[index]).draw(x + region.x * sx, y + region.y * sy, z, region.width * sx, region.height * sy);
+        }
+        ofPopStyle();
     }
     
-    void Manager::update()
+    void Manager::updateOutputs()
     {
-        for (const auto& e : mContents)
+        mOutputShownPrevious.swap(mOutputShown);
+        mOutputShown.clear();
+        for (const auto& handle : mOutputShownPrevious)
         {
-            if (e->opacity > 0.0 || bBackgroundUpdate)
+            myContent* o = lookup(handle);
+            if (o) mFlags[o->index] &= ~FLAG_OUTPUT;
+        }
+        
+        for (const auto& output : mOutputs)
+        {
+            if (!output->isEnabled()) continue;
+            buildOutputLayers(output);
+            for (const int i : mOutputLayers)
             {
-                e->obj->update();
-                
-                e->fbo.begin();
-                ofClear(0);
-                glPushAttrib(GL_ALL_ATTRIB_BITS);
-                ofPushMatrix();
-                ofPushStyle();
-                e->obj->draw();
-                ofPopStyle();
-                ofPopMatrix();
-                glPopAttrib();
-                e->fbo.end();
+                if (mOutputOpacities[i] <= 0.0 || (mFlags[i] & FLAG_OUTPUT)) continue;
+                mFlags[i] |= FLAG_OUTPUT;
+                mOutputShown.push_back(mContents[i]->obj->handle);
             }
         }
+        
+        // no longer shown anywhere, same as becoming hidden in syncOpacity()
+        if (bBackgroundUpdate) return;
+        for (const auto& handle : mOutputShownPrevious)
+        {
+            myContent* o = lookup(handle);
+            if (o && !(mFlags[o->index] & (FLAG_VISIBLE | FLAG_OUTPUT))) suspendContent(o);
+        }
     }
     
-    void Manager::draw(const float x, const float y, const float z, const float width, const float height)
+    void Manager::buildOutputLayers(const Output* output)
     {
-        ofColor currentColor = ofGetStyle().color;
-        for (const auto& e : mContents)
+        mOutputOpacities = mOpacities;
+        for (const auto& e : output->getOpacities())
+        {
+            myContent* o = lookup(e.first);
+            if (o) mOutputOpacities[o->index] = e.second;
+        }
+        
+        mOutputLayers.clear();
+        if (output->hasLayers())
         {
-            if (e->opacity > 0.0)
+            for (const auto& handle : output->getLayers())
             {
-                ofPushStyle();
-                ofSetColor(currentColor, e->opacity * currentColor.a);
-#if (OF_VERSION_MAJOR == 0 && OF_VERSION_MINOR < 9)
-                e->fbo.getTextureReference().draw(x, y, z, width, height);
-#else
-                e->fbo.getTexture().draw(x, y, z, width, height);
-#endif
-                ofPopStyle();
+                myContent* o = lookup(handle);
+                if (o) mOutputLayers.push_back(o->index);
             }
+            sort(mOutputLayers.begin(), mOutputLayers.end());
+            mOutputLayers.erase(unique(mOutputLayers.begin(), mOutputLayers.end()), mOutputLayers.end());
+            return;
+        }
+        
+        // every visible content, and hidden ones shown by overrides
+        mOutputLayers = mVisible;
+        for (const auto& e : output->getOpacities())
+        {
+            myContent* o = lookup(e.first);
+            if (o && e.second > 0.0 && !(mFlags[o->index] & FLAG_VISIBLE)) mOutputLayers.push_back(o->index);
+        }
+        if (mOutputLayers.size() > mVisible.size())
+        {
+            sort(mOutputLayers.begin(), mOutputLayers.end());
+            mOutputLayers.erase(unique(mOutputLayers.begin(), mOutputLayers.end()), mOutputLayers.end());
+        }
+    }
+    
+    void Manager::compositeOutputs()
+    {
+        for (const auto& output : mOutputs)
+        {
+            if (!output->isEnabled()) continue;
+            buildOutputLayers(output);
+            
+            ofFbo& fbo = output->getCompositeBuffer();
+            fbo.begin();
+            ofClear(0);
+            ofPushStyle();
+            ofSetColor(255);
+            compositeLayers(mOutputLayers, mOutputOpacities, false, 0, 0, 0, fbo.getWidth(), fbo.getHeight());
+            ofPopStyle();
+            fbo.end();
+            output->downsample();
         }
     }
     
@@ -149,138 +1160,596 @@ namespace ofxContentsManager
     void Manager::setOpacity(const int nid, const float opacity)
     {
         if (!isValid(nid)) return;
-        mContents[nid]->opacity = ofClamp(opacity, 0.0, 1.0);
+        cancelTransition(mContents[nid]);
+        if (bOpacityBatch) writeOpacity(mContents[nid], ofClamp(opacity, 0.0, 1.0));
+        else mContents[nid]->opacity = ofClamp(opacity, 0.0, 1.0);
     }
     
     void Manager::setOpacity(const string &name, const float opacity)
     {
-        for (auto& o : mContents)
+        pair<name_index_it, name_index_it> range = mNameIndex.equal_range(name);
+        for (name_index_it it = range.first; it != range.second; ++it)
         {
-            if (o->obj->getName() == name)
-            {
-                o->opacity = ofClamp(opacity, 0.0, 1.0);
-            }
+            cancelTransition(it->second);
+            if (bOpacityBatch) writeOpacity(it->second, ofClamp(opacity, 0.0, 1.0));
+            else it->second->opacity = ofClamp(opacity, 0.0, 1.0);
         }
     }
     
+    void Manager::setOpacity(const ContentHandle& handle, const float opacity)
+    {
+        myContent* o = resolve(handle);
+        if (o) setOpacity(o->index, opacity);
+    }
+    
     void Manager::setOpacityAll(const float opacity)
     {
+        mTransitionLayers.clear();
         for (auto& e : mContents)
         {
-            e->opacity = ofClamp(opacity, 0.0, 1.0);
+            writeOpacity(e, ofClamp(opacity, 0.0, 1.0));
+        }
+    }
+    
+    void Manager::setOpacities(const vector<float>& opacities)
+    {
+        const int num = min(opacities.size(), mContents.size());
+        for (int i = 0; i < num; ++i)
+        {
+            cancelTransition(mContents[i]);
+            writeOpacity(mContents[i], ofClamp(opacities[i], 0.0, 1.0));
         }
     }
     
-    void Manager::switchContent(const int nid)
+    void Manager::switchContent(const int nid, const float duration, const Easing easing)
     {
         if (!isValid(nid)) return;
+        if (mContents[nid]->obj->state == CONTENT_LOADING)
+        {
+            // switch when the content is ready
+            mPendingSwitch.active = true;
+            mPendingSwitch.byName = false;
+            mPendingSwitch.o = mContents[nid];
+            mPendingSwitch.duration = duration;
+            mPendingSwitch.easing = easing;
+            return;
+        }
+        if (mContents[nid]->obj->state == CONTENT_FAILED)
+        {
+            // keep current output instead of switching to nothing
+            ofLogWarning(MODULE_NAME) << "content failed to load, switching is canceled: " << mContents[nid]->obj->getName();
+            mPendingSwitch.active = false;
+            return;
+        }
+        mPendingSwitch.active = false;
+        mTransitionLayers.clear();
         for (int i = 0; i < mContents.size(); ++i)
         {
-            if (i == nid)
+            myContent* o = mContents[i];
+            const float target = i == nid ? 1.0 : 0.0;
+            if (duration <= 0)
             {
-                mContents[i]->opacity = 1.0;
+                writeOpacity(o, target);
             }
-            else {
-                mContents[i]->opacity = 0.0;
+            else if (o->opacity != target)
+            {
+                myTransitionLayer layer = { o, o->opacity, target };
+                mTransitionLayers.push_back(layer);
             }
         }
         mCurrentContent = nid;
+        beginTransition(duration, easing);
     }
     
-    void Manager::switchContent(const string& name)
+    void Manager::switchContent(const string& name, const float duration, const Easing easing)
     {
+        pair<name_index_it, name_index_it> range = mNameIndex.equal_range(name);
+        for (name_index_it it = range.first; it != range.second; ++it)
+        {
+            if (it->second->obj->state == CONTENT_LOADING)
+            {
+                // switch when the contents are ready
+                mPendingSwitch.active = true;
+                mPendingSwitch.byName = true;
+                mPendingSwitch.name = name;
+                mPendingSwitch.o = NULL;
+                mPendingSwitch.duration = duration;
+                mPendingSwitch.easing = easing;
+                return;
+            }
+        }
+        if (range.first != range.second)
+        {
+            bool failed = true;
+            for (name_index_it it = range.first; it != range.second; ++it)
+            {
+                if (it->second->obj->state != CONTENT_FAILED) { failed = false; break; }
+            }
+            if (failed)
+            {
+                // keep current output instead of switching to nothing
+                ofLogWarning(MODULE_NAME) << "content failed to load, switching is canceled: " << name;
+                mPendingSwitch.active = false;
+                return;
+            }
+        }
+        mPendingSwitch.active = false;
+        mTransitionLayers.clear();
         for (auto& o : mContents)
         {
-            if (o->obj->getName() == name)
+            bool match = false;
+            for (name_index_it it = range.first; it != range.second; ++it)
+            {
+                if (it->second == o) { match = true; break; }
+            }
+            const float target = match ? 1.0 : 0.0;
+            if (duration <= 0)
             {
-                o->opacity = 1.0;
+                writeOpacity(o, target);
             }
-            else {
-                o->opacity = 0.0;
+            else if (o->opacity != target)
+            {
+                myTransitionLayer layer = { o, o->opacity, target };
+                mTransitionLayers.push_back(layer);
             }
         }
+        beginTransition(duration, easing);
+    }
+    
+    void Manager::switchContent(const ContentHandle& handle, const float duration, const Easing easing)
+    {
+        myContent* o = resolve(handle);
+        if (o) switchContent(o->index, duration, easing);
+    }
+    
+    void Manager::switchNextContent(bool loop, const float duration, const Easing easing)
+    {
+        // mCurrentContent moves when the switch actually happens
+        int next = mCurrentContent + 1;
+        if (next >= mContents.size())
+        {
+            next = loop ? 0 : mContents.size() - 1;
+        }
+        switchContent(next, duration, easing);
+    }
+    
+    void Manager::switchPreviousContent(bool loop, const float duration, const Easing easing)
+    {
+        int previous = mCurrentContent - 1;
+        if (previous < 0)
+        {
+            previous = loop ? mContents.size() - 1 : 0;
+        }
+        switchContent(previous, duration, easing);
+    }
+    
+    void Manager::prewarm(const int nid)
+    {
+        if (!isValid(nid)) return;
+        if (!mContents[nid]->obj->bWarm) mPrewarmQueue.push_back(mContents[nid]);
+    }
+    
+    void Manager::prewarm(const string& name)
+    {
+        pair<name_index_it, name_index_it> range = mNameIndex.equal_range(name);
+        for (name_index_it it = range.first; it != range.second; ++it)
+        {
+            if (!it->second->obj->bWarm) mPrewarmQueue.push_back(it->second);
+        }
+    }
+    
+    void Manager::prewarmAll()
+    {
+        for (auto& o : mContents)
+        {
+            if (!o->obj->bWarm) mPrewarmQueue.push_back(o);
+        }
+    }
+    
+    void Manager::beginTransition(const float duration, const Easing easing)
+    {
+        mTransitionStart = mTime;
+        mTransitionDuration = duration;
+        mTransitionEasing = easing;
     }
     
-    void Manager::switchNextContent(bool loop)
+    void Manager::updateTransition(const float time)
     {
-        mCurrentContent++;
-        if (mCurrentContent >= mContents.size())
+        const float t = ofClamp((time - mTransitionStart) / mTransitionDuration, 0.0, 1.0);
+        if (t < 1.0)
         {
-            loop ? mCurrentContent = 0 : mCurrentContent = mContents.size() - 1;
+            // intermediate values are written silently, listeners are notified once at the end
+            const float k = ease(mTransitionEasing, t);
+            for (auto& layer : mTransitionLayers)
+            {
+                layer.o->opacity.setWithoutEventNotifications(ofLerp(layer.from, layer.to, k));
+                syncOpacity(layer.o);
+            }
+            return;
+        }
+        
+        // outgoing layers reach zero here, their pooled frame buffers are given back
+        for (auto& layer : mTransitionLayers)
+        {
+            writeOpacity(layer.o, layer.to);
         }
-        switchContent(mCurrentContent);
+        mTransitionLayers.clear();
     }
     
-    void Manager::switchPreviousContent(bool loop)
+    void Manager::cancelTransition(myContent* o)
     {
-        mCurrentContent--;
-        if (mCurrentContent < 0)
+        for (vector<myTransitionLayer>::iterator it = mTransitionLayers.begin(); it != mTransitionLayers.end(); ++it)
         {
-            loop ? mCurrentContent = mContents.size() - 1 : mCurrentContent = 0;
+            if (it->o == o)
+            {
+                mTransitionLayers.erase(it);
+                return;
+            }
         }
-        switchContent(mCurrentContent);
     }
     
     void Manager::enableBackgroundUpdate(bool enable)
     {
+        if (bBackgroundUpdate && !enable)
+        {
+            for (int i = 0; i < mContents.size(); ++i)
+            {
+                if (!(mFlags[i] & (FLAG_VISIBLE | FLAG_OUTPUT))) suspendContent(mContents[i]);
+            }
+        }
         bBackgroundUpdate = enable;
     }
     
+    void Manager::enableScheduledBackgroundUpdate(bool enable, const float milliseconds)
+    {
+        bScheduledBackgroundUpdate = enable;
+        mBackgroundBudget = milliseconds;
+    }
+    
+    float Manager::getStaleness(const int nid)
+    {
+        if (!isValid(nid)) return 0;
+        return mTime - mContents[nid]->obj->serviceTime;
+    }
+    
     void Manager::allocateBuffer(const float width, const float height, const int internalformat, const int numSamples)
     {
         setup(width, height, internalformat, numSamples);
         allocateBuffer(mFboSettings);
     }
     
+    void Manager::allocatePool()
+    {
+        // leases are given back first, so the pool drops every buffer of the old settings
+        for (auto& o : mContents)
+        {
+            releaseBuffer(o); // leased again with the new settings
+        }
+        mFboPool.allocate(mFboSettings);
+    }
+    
+    void Manager::enableFboPool(bool enable, const int maxFbos)
+    {
+        if (enable == bFboPool)
+        {
+            mFboPool.setMaxFbos(maxFbos);
+            return;
+        }
+        
+        for (auto& o : mContents)
+        {
+            releaseBuffer(o);
+        }
+        bFboPool = enable;
+        
+        if (bFboPool)
+        {
+            mFboPool.setup(mFboSettings, maxFbos);
+        }
+        else
+        {
+            mFboPool.clear();
+            for (auto& o : mContents)
+            {
+                allocateContentBuffer(o);
+            }
+        }
+    }
+    
+    void Manager::enableCompositor(bool enable, const int maxLayersPerPass)
+    {
+        bCompositor = enable;
+        if (bCompositor && !mCompositor.setup(mFboSettings.textureTarget, maxLayersPerPass))
+        {
+            ofLogError(MODULE_NAME) << "compositor is not available, fall back to drawing each content";
+            bCompositor = false;
+        }
+    }
+    
+    void Manager::enableReadback(bool enable, const int numBuffers)
+    {
+        bReadback = enable;
+        if (!bReadback)
+        {
+            mReadback.close();
+            mOutputFbo.clear();
+            return;
+        }
+        
+        ofFbo::Settings settings = mFboSettings;
+        settings.internalformat = GL_RGBA;
+        settings.numSamples = 0;
+        mOutputFbo.allocate(settings);
+        mReadback.setup(settings.width, settings.height, numBuffers);
+    }
+    
+    ofTexture& Manager::getOutputTexture()
+    {
+        return getTexture(mOutputFbo);
+    }
+    
+    void Manager::setClock(ClockMode mode, const float fps)
+    {
+        mClockMode = mode;
+        mClockStep = fps > 0 ? 1.0 / fps : 1.0 / 60;
+        mFrameNum = 0;
+        mDeltaTime = 0;
+        bClockStarted = false;
+        rebaseClock(mClockMode == CLOCK_MODE_FIXED_STEP ? 0 : ofGetElapsedTimef());
+    }
+    
+    bool Manager::beginOfflineRender(const string& directory, const float fps, const int numFrames, const string& extension)
+    {
+        if (bOfflineRender) endOfflineRender();
+        if (!mSequenceWriter.setup(directory, extension)) return false;
+        
+        bOfflineReadback = !bReadback;
+        if (bOfflineReadback) enableReadback(true);
+        if (!mReadback.isSetup())
+        {
+            ofLogError(MODULE_NAME) << "offline rendering requires readback";
+            mSequenceWriter.close();
+            if (bOfflineReadback) enableReadback(false);
+            return false;
+        }
+        
+        // finished frames are chained to the user's callback
+        mOfflineCallback = mReadback.getCallback();
+        mReadback.setCallback([this](const ReadbackFrame& frame) {
+            writeOfflineFrame(frame);
+            if (mOfflineCallback) mOfflineCallback(frame);
+        });
+        bOfflineDropFrames = mReadback.getDropFrames();
+        mReadback.setDropFrames(false);
+        
+        mOfflineClockMode = mClockMode;
+        mOfflineClockStep = mClockStep;
+        setClock(CLOCK_MODE_FIXED_STEP, fps);
+        
+        mOfflineFirstFrame = mReadback.getNumRequested();
+        mOfflineNumFrames = max(numFrames, 0);
+        bOfflineRender = true;
+        return true;
+    }
+    
+    void Manager::endOfflineRender()
+    {
+        if (!bOfflineRender) return;
+        
+        mReadback.flush();
+        mSequenceWriter.close();
+        bOfflineRender = false;
+        
+        mReadback.setCallback(mOfflineCallback);
+        mOfflineCallback = nullptr;
+        mReadback.setDropFrames(bOfflineDropFrames);
+        if (bOfflineReadback) enableReadback(false);
+        setClock(mOfflineClockMode, 1.0 / mOfflineClockStep);
+        
+        ofLogNotice(MODULE_NAME) << "offline rendering finished: " << mSequenceWriter.getNumWritten() << " frames";
+    }
+    
+    void Manager::writeOfflineFrame(const ReadbackFrame& frame)
+    {
+        // frames requested before beginOfflineRender() are not part of the sequence
+        if (frame.frameNumber < mOfflineFirstFrame) return;
+        mSequenceWriter.push(frame.pixels, frame.width, frame.height, frame.frameNumber - mOfflineFirstFrame);
+    }
+    
+    bool Manager::needsIsolation() const
+    {
+        // the frame buffer itself is part of these settings
+        return !bPassThrough || resolutionScale != 1 || renderWidth > 0 || renderHeight > 0 || renderInterval > 0 || bRenderCache;
+    }
+    
+    Output& Manager::addOutput(const string& name, const int width, const int height)
+    {
+        Output* output = getOutput(name);
+        if (output == NULL)
+        {
+            output = new Output();
+            mOutputs.push_back(output);
+        }
+        output->setup(name, width, height, mFboSettings);
+        return *output;
+    }
+    
+    Output* Manager::getOutput(const string& name)
+    {
+        for (auto& output : mOutputs)
+        {
+            if (output->getName() == name) return output;
+        }
+        return NULL;
+    }
+    
+    void Manager::removeOutput(const string& name)
+    {
+        for (auto it = mOutputs.begin(); it != mOutputs.end(); ++it)
+        {
+            if ((*it)->getName() != name) continue;
+            delete *it;
+            mOutputs.erase(it);
+            return;
+        }
+    }
+    
+    void Manager::enableOcclusionCulling(bool enable, bool updateOccluded)
+    {
+        bOcclusionCulling = enable;
+        bUpdateOccluded = updateOccluded;
+        if (bOcclusionCulling) return;
+        for (const int i : mVisible)
+        {
+            mFlags[i] &= ~FLAG_OCCLUDED;
+        }
+    }
+    
+    void Manager::enableUpdateThreads(bool enable, const int numThreads)
+    {
+        bUpdateThreads = enable;
+        if (bUpdateThreads) mWorkerPool.setup(numThreads);
+        else mWorkerPool.close();
+    }
+    
+    void Manager::enableProfiler(bool enable)
+    {
+#if OFX_CONTENTS_MANAGER_PROFILER
+        bProfiler = enable;
+#else
+        if (enable) ofLogWarning(MODULE_NAME) << "profiler is compiled out, define OFX_CONTENTS_MANAGER_PROFILER 1";
+#endif
+    }
+    
+    void Manager::updateProfiler()
+    {
+#if OFX_CONTENTS_MANAGER_PROFILER
+        for (const auto& e : mContents)
+        {
+            e->gpuTimer.poll();
+            e->updateParam = e->updateTimer.getAverage();
+            e->drawParam = e->drawTimer.getAverage();
+            e->gpuParam = e->gpuTimer.getTimer().getAverage();
+        }
+        mCompositeGpuTimer.poll();
+        mCompositeParam = mCompositeTimer.getAverage();
+        mCompositeGpuParam = mCompositeGpuTimer.getTimer().getAverage();
+#endif
+    }
+    
+    ContentStats Manager::getContentStats(const int nid)
+    {
+        ContentStats stats;
+        if (!isValid(nid)) return stats;
+        myContent* o = mContents[nid];
+        stats.name = o->obj->getName();
+#if OFX_CONTENTS_MANAGER_PROFILER
+        stats.update = o->updateTimer.getStats();
+        stats.draw = o->drawTimer.getStats();
+        stats.gpu = o->gpuTimer.getTimer().getStats();
+#endif
+        return stats;
+    }
+    
+    TimingStats Manager::getCompositeStats() const
+    {
+#if OFX_CONTENTS_MANAGER_PROFILER
+        return mCompositeTimer.getStats();
+#else
+        return TimingStats();
+#endif
+    }
+    
+    TimingStats Manager::getCompositeGpuStats() const
+    {
+#if OFX_CONTENTS_MANAGER_PROFILER
+        return mCompositeGpuTimer.getTimer().getStats();
+#else
+        return TimingStats();
+#endif
+    }
+    
+    const ofParameterGroup& Manager::getProfilerParameterGroup(const string& groupName)
+    {
+        // rebuilt on request, so removed contents disappear
+        mProfilerParams.clear();
+        mProfilerParams.setName(groupName);
+#if OFX_CONTENTS_MANAGER_PROFILER
+        mProfilerParams.add(mCompositeParam.set("composite ms", 0.0, 0.0, 33.3));
+        mProfilerParams.add(mCompositeGpuParam.set("composite gpu ms", 0.0, 0.0, 33.3));
+        for (const auto& e : mContents)
+        {
+            mProfilerParams.add(e->profileParams);
+        }
+#endif
+        return mProfilerParams;
+    }
+    
     void Manager::allocateBuffer(const ofFbo::Settings& settings)
     {
+        mFboSettings = settings;
+        if (bFboPool) allocatePool();
         for (auto& o : mContents)
         {
-            o->fbo.allocate(settings);
-            o->obj->bufferWidth  = settings.width;
-            o->obj->bufferHeight = settings.height;
-            o->obj->bufferResized(settings.width, settings.height);
+            applyBufferSize(o->obj);
+            if (!bFboPool && !isFlattened(o)) allocateContentBuffer(o);
+            o->obj->bufferResized(o->obj->bufferWidth, o->obj->bufferHeight);
+        }
+        if (bReadback) enableReadback(true, mReadback.getNumBuffers());
+        for (auto& output : mOutputs)
+        {
+            output->setup(output->getName(), output->getWidth(), output->getHeight(), mFboSettings);
         }
     }
     
     
-    void Manager::addContent(ofxContentsManager::Content *newContentPtr)
+    ContentHandle Manager::addContent(ofxContentsManager::Content *newContentPtr)
     {
-        setupContent(newContentPtr);
+        return setupContent(newContentPtr)->getHandle();
     }
     
     
     bool Manager::removeContent(const int nid)
     {
         if (!isValid(nid)) return false;
-        contents_it it = mContents.begin() + nid;
-        myContent* o = *it;
-        o->obj->exit();
-        o->opacity.removeListener(o->obj, &Content::onOpacityChanged);
-        delete o->obj;
-        delete o;
-        mContents.erase(it);
+        eraseContent(nid);
         return true;
     }
     
     void Manager::removeContent(const string& name)
     {
-        contents_it it = mContents.begin();
-        while (it != mContents.end())
+        name_index_it found;
+        while ((found = mNameIndex.find(name)) != mNameIndex.end())
         {
-            if ((*it)->obj->getName() == name)
-            {
-                myContent* o = *it;
-                o->obj->exit();
-                o->opacity.removeListener(o->obj, &Content::onOpacityChanged);
-                delete o->obj;
-                delete o;
-                it = mContents.erase(it);
-            }
-            else ++it;
+            eraseContent(found->second->index);
         }
     }
     
+    bool Manager::removeContent(const ContentHandle& handle)
+    {
+        myContent* o = resolve(handle);
+        if (o == NULL) return false;
+        eraseContent(o->index);
+        return true;
+    }
+    
+    bool Manager::contains(const ContentHandle& handle) const
+    {
+        return !handle.isNull() && handle.slot < mSlots.size() && mSlots[handle.slot].generation == handle.generation
+            && mSlots[handle.slot].o != NULL;
+    }
+    
+    ContentHandle Manager::getHandle(const int nid)
+    {
+        if (!isValid(nid)) return ContentHandle();
+        return mContents[nid]->obj->handle;
+    }
+    
+    int Manager::getIndex(const ContentHandle& handle) const
+    {
+        return contains(handle) ? mSlots[handle.slot].o->index : -1;
+    }
+    
     Content* Manager::getContent(const int nid)
     {
         if (!isValid(nid)) return NULL;
@@ -288,6 +1757,12 @@ namespace ofxContentsManager
         return (*it)->obj;
     }
     
+    Content* Manager::getContent(const ContentHandle& handle)
+    {
+        myContent* o = resolve(handle);
+        return o ? o->obj : NULL;
+    }
+    
     vector<Content*> Manager::getAllContents()
     {
         vector<Content*> dst;
@@ -313,15 +1788,18 @@ namespace ofxContentsManager
     
     void Manager::clear()
     {
-        typename vector<myContent*>::iterator it = mContents.begin();
-        while (it != mContents.end())
+        for (auto& o : mContents)
         {
-            myContent* o = *it;
-            o->obj->exit();
-            delete o->obj;
-            delete o;
+            destroyContent(o);
         }
         mContents.clear();
+        mOpacities.clear();
+        mFlags.clear();
+        mTypeIDs.clear();
+        mFbos.clear();
+        mVisible.clear();
+        mTypeIndex.clear();
         mOpacityParams.clear();
+        mArena.reset();
     }
 }
@@ -1,6 +1,17 @@
 #pragma once
 
 #include "ofMain.h"
+#include "ofxContentsManagerFboPool.h"
+#include "ofxContentsManagerCompositor.h"
+#include "ofxContentsManagerWorkerPool.h"
+#include "ofxContentsManagerStateGuard.h"
+#include "ofxContentsManagerProfiler.h"
+#include "ofxContentsManagerLoader.h"
+#include "ofxContentsManagerArena.h"
+#include "ofxContentsManagerReadback.h"
+#include "ofxContentsManagerImageSequenceWriter.h"
+#include "ofxContentsManagerHandle.h"
+#include "ofxContentsManagerOutput.h"
 
 namespace ofxContentsManager
 {
@@ -18,6 +29,41 @@ namespace ofxContentsManager
     };
     
     
+    /**
+     *  Easing curve of timed transitions
+     */
+    enum Easing
+    {
+        EASE_LINEAR = 0,
+        EASE_IN_QUAD,
+        EASE_OUT_QUAD,
+        EASE_IN_OUT_QUAD,
+        EASE_IN_OUT_CUBIC,
+        EASE_IN_OUT_SINE
+    };
+    
+    
+    /**
+     *  Readiness of a content, the manager updates and draws only ready contents
+     */
+    enum ContentState
+    {
+        CONTENT_LOADING = 0,    ///< load() or setupGL() has not finished
+        CONTENT_READY,
+        CONTENT_FAILED          ///< load() or setupGL() returned false
+    };
+    
+    
+    /**
+     *  Time source of the manager's clock
+     */
+    enum ClockMode
+    {
+        CLOCK_MODE_REALTIME = 0,    ///< ofGetElapsedTimef()
+        CLOCK_MODE_FIXED_STEP       ///< advance a fixed step every manager update, starts from 0
+    };
+    
+    
     //---------------------------------------------------------------------------------------
     /*
         BASE CONTENT CLASS
@@ -30,6 +76,36 @@ namespace ofxContentsManager
         float   bufferWidth;
         float   bufferHeight;
         string  contentName;
+        Manager* parentManager;
+        ContentHandle handle;
+        bool    bRenderCache;
+        bool    bInvalidated;
+        
+        float   renderInterval;
+        float   nextRenderTime;
+        float   updateInterval;
+        float   updateAccumulator;
+        float   lastUpdateTime;
+        int     numMissedRenders;
+        
+        bool    bThreadSafeUpdate;
+        float   updateDuration;
+        
+        StateIsolation stateIsolation;
+        bool    bWarm;
+        ContentState state;
+        
+        float   resolutionScale;
+        int     renderWidth;
+        int     renderHeight;
+        GLint   upsampleFilter;
+        
+        float   backgroundPriority;
+        float   serviceTime;
+        
+        bool    bOpaque;
+        ofRectangle opaqueRect;
+        ofRectangle region;
         
         void    onOpacityChanged(float& e) { opacityChanged(e); }
         
@@ -38,15 +114,164 @@ namespace ofxContentsManager
         float   getHeight() const { return bufferHeight; }
         
     public:
-        Content() : bufferWidth(0), bufferHeight(0){}
+        Content()
+        : bufferWidth(0), bufferHeight(0), parentManager(NULL), bRenderCache(false), bInvalidated(true)
+        , renderInterval(0), nextRenderTime(-1), updateInterval(0), updateAccumulator(0), lastUpdateTime(-1), numMissedRenders(0)
+        , bThreadSafeUpdate(false), updateDuration(0), stateIsolation(ISOLATE_COMMON), bWarm(false), state(CONTENT_LOADING)
+        , resolutionScale(1), renderWidth(0), renderHeight(0), upsampleFilter(GL_LINEAR)
+        , backgroundPriority(1), serviceTime(0), bOpaque(false){}
         virtual ~Content(){}
         
+        virtual bool load(){ return true; } ///< load resources, called on a loader thread when async loading is enabled, must not call GL
+        virtual bool setupGL(){ return true; } ///< create GL resources, called on main thread after load()
         virtual void update(){}
         virtual void draw(){}
         
         virtual void exit(){}; /// callback when just removing this object or called exit from base manager
         virtual void bufferResized(float width, float height){} ///< callback when changed buffer size
         virtual void opacityChanged(float opacity){} ///< callback when base manager changing opacity
+        virtual bool isOutputChanged(){ return false; } ///< polled after update() when render cache is enabled, return true to redraw
+        virtual void renderMissed(int numSlots){} ///< callback when the manager could not render this object in time for its render rate
+        virtual void warmed(){} ///< callback when draw() was rendered for the first time, by prewarm or by becoming visible
+        
+        /**
+         *  Setting render cache, the manager skip draw() and reuse last frame buffer
+         *  until invalidate() is called or isOutputChanged() return true.
+         *  (default is disable, draw() is called every frame)
+         *
+         *  @param enable true or false
+         */
+        void enableRenderCache(bool enable) { bRenderCache = enable; bInvalidated = true; }
+        
+        /**
+         *  Request redraw on next manager update, when render cache is enabled
+         */
+        void invalidate() { bInvalidated = true; }
+        
+        /**
+         *  Setting render rate, the manager call draw() at this rate and keep compositing last frame buffer between renders
+         *
+         *  @param fps Renders per second (0 = every manager update, default)
+         */
+        void setRenderRate(float fps) { renderInterval = fps > 0 ? 1.0 / fps : 0; nextRenderTime = -1; }
+        
+        /**
+         *  Setting fixed-step update rate, the manager call update() as many times as steps elapsed (up to 4 per frame)
+         *
+         *  @param hz Updates per second (0 = once per manager update, default)
+         */
+        void setUpdateRate(float hz) { updateInterval = hz > 0 ? 1.0 / hz : 0; lastUpdateTime = -1; }
+        
+        /**
+         *  Declare update() does not call any GL / openFrameworks drawing functions,
+         *  so the manager can run it on a worker thread when update threads are enabled.
+         *  (default is false)
+         *
+         *  @param threadSafe true or false
+         */
+        void setUpdateThreadSafe(bool threadSafe) { bThreadSafeUpdate = threadSafe; }
+        
+        /**
+         *  Offer duration of last update() calls in the manager update
+         *
+         *  @return milliseconds
+         */
+        float getUpdateDuration() const { return updateDuration; }
+        
+        /**
+         *  Setting how much GL state the manager restores after draw()
+         *
+         *  @param isolation ISOLATE_NONE, ISOLATE_COMMON (default) or ISOLATE_ALL
+         */
+        void setStateIsolation(StateIsolation isolation) { stateIsolation = isolation; }
+        StateIsolation getStateIsolation() const { return stateIsolation; }
+        
+        /**
+         *  Offer is this object rendered at least once
+         *
+         *  @return true or false
+         */
+        bool isWarm() const { return bWarm; }
+        
+        /**
+         *  Offer readiness of this object
+         *
+         *  @return CONTENT_LOADING, CONTENT_READY or CONTENT_FAILED
+         */
+        ContentState getState() const { return state; }
+        bool isReady() const { return state == CONTENT_READY; }
+        
+        /**
+         *  Setting frame buffer resolution relative to the manager's buffer size.
+         *  getWidth() / getHeight() keep reporting the logical size, draw() is scaled to fit.
+         *
+         *  @param scale Resolution scale, e.g. 0.25 for quarter resolution (default = 1)
+         */
+        void setResolutionScale(float scale);
+        
+        /**
+         *  Setting explicit frame buffer size, overrides resolution scale
+         *
+         *  @param width    Frame buffer width (0 = use resolution scale)
+         *  @param height   Frame buffer height (0 = use resolution scale)
+         */
+        void setRenderSize(int width, int height);
+        
+        /**
+         *  Setting texture filter used when the frame buffer is upsampled in compositing
+         *
+         *  @param filter GL_LINEAR (default) or GL_NEAREST
+         */
+        void setUpsampleFilter(GLint filter);
+        
+        /**
+         *  Setting placement rectangle in the manager's buffer, the frame buffer is allocated in this size
+         *  and only this rectangle is composited. getWidth() / getHeight() offer the rectangle size.
+         *
+         *  @param rect Rectangle in the manager's buffer coordinates (empty = whole buffer, default)
+         */
+        void setRegion(const ofRectangle& rect);
+        void setRegion(float x, float y, float width, float height) { setRegion(ofRectangle(x, y, width, height)); }
+        const ofRectangle& getRegion() const { return region; }
+        bool hasRegion() const { return !region.isEmpty(); }
+        
+        /**
+         *  Setting priority in scheduled background update, the stalest content weighted by priority is updated first
+         *
+         *  @param priority Priority (default = 1)
+         */
+        void setBackgroundPriority(float priority) { backgroundPriority = max(priority, 0.0f); }
+        float getBackgroundPriority() const { return backgroundPriority; }
+        
+        /**
+         *  Declare this object's output is fully opaque (every pixel is drawn with alpha 1).
+         *  While opacity is 1, layers completely hidden beneath it are culled by the manager's occlusion culling.
+         *
+         *  @param opaque true or false (default = false)
+         */
+        void setOpaque(bool opaque) { bOpaque = opaque; opaqueRect = ofRectangle(); }
+        
+        /**
+         *  Declare this object's output is opaque only in the rectangle
+         *
+         *  @param rect Opaque rectangle in this object's coordinates (getWidth() x getHeight())
+         */
+        void setOpaque(const ofRectangle& rect) { bOpaque = true; opaqueRect = rect; }
+        bool isOpaque() const { return bOpaque; }
+        
+        float getResolutionScale() const { return resolutionScale; }
+        int getRenderWidth() const;
+        int getRenderHeight() const;
+        
+        float getRenderRate() const { return renderInterval > 0 ? 1.0 / renderInterval : 0; }
+        float getUpdateRate() const { return updateInterval > 0 ? 1.0 / updateInterval : 0; }
+        
+        /**
+         *  Offer total number of render slots missed since added to the manager
+         *
+         *  @return number
+         */
+        int getNumMissedRenders() const { return numMissedRenders; }
         
         /**
          *  Setting this object name
@@ -57,10 +282,40 @@ namespace ofxContentsManager
         
         /**
          *  Offer this object name, if the object had not been setting name, this function return tha class name
+         *  (the demangled class name is cached per type, so this call does not allocate)
          *
          *  @return object name string
          */
-        string getName();
+        const string& getName();
+        
+        /**
+         *  Offer this object's handle in the parent manager
+         *
+         *  @return ContentHandle (null handle when this object is not added to a manager)
+         */
+        ContentHandle getHandle() const { return handle; }
+        
+        /**
+         *  Offer time of the parent manager's clock, use this instead of ofGetElapsedTimef()
+         *  so this object follows fixed-step and offline rendering
+         *
+         *  @return seconds (ofGetElapsedTimef() when this object is not added to a manager)
+         */
+        float getTime() const;
+        
+        /**
+         *  Offer time step of this update(), use this instead of ofGetLastFrameTime()
+         *
+         *  @return seconds (update interval when update rate is set)
+         */
+        float getDeltaTime() const;
+        
+        /**
+         *  Offer number of the parent manager's updates, use this instead of ofGetFrameNum()
+         *
+         *  @return frame number (ofGetFrameNum() when this object is not added to a manager)
+         */
+        uint64_t getFrameNum() const;
     };
     
     
@@ -73,27 +328,232 @@ namespace ofxContentsManager
     
     class Manager : public Content
     {
+        friend  class Content;
+        
     protected:
-        typedef struct
+        // cold per-content data, the hot data lives in the parallel arrays below
+        struct myContent
         {
+            Manager*            manager;
+            int                 index;
+            uint32_t            slot;
             Content*            obj;
+            Manager*            group;          // obj as a nested manager, NULL for other contents
+            void*               objMemory;      // arena memory of obj, NULL when obj is allocated by new
+            size_t              objSize;
+            size_t              objAlignment;
+            float               notifiedOpacity;    // last value opacity listeners were notified
+            bool                bOpacityDirty;
             ofParameter<float>  opacity;
-            ofFbo               fbo;
-            RTTI::TypeID        typeID;
-        } myContent;
+#if OFX_CONTENTS_MANAGER_PROFILER
+            RollingTimer        updateTimer;
+            RollingTimer        drawTimer;
+            GpuTimer            gpuTimer;
+            ofParameterGroup    profileParams;
+            ofParameter<float>  updateParam;
+            ofParameter<float>  drawParam;
+            ofParameter<float>  gpuParam;
+#endif
+            void onOpacityChanged(float& value) { notifiedOpacity = value; manager->syncOpacity(this); }
+        };
+        
+        enum
+        {
+            FLAG_READY      = 1 << 0,
+            FLAG_VISIBLE    = 1 << 1,
+            FLAG_OCCLUDED   = 1 << 2,   // hidden beneath opaque contents
+            FLAG_OUTPUT     = 1 << 3    // shown in an output
+        };
 
+        typedef struct
+        {
+            myContent*          o;
+            float               from;
+            float               to;
+        } myTransitionLayer;
+        
         typedef vector<myContent*>::iterator contents_it;
+        typedef unordered_multimap<string, myContent*> name_index;
+        typedef name_index::iterator name_index_it;
+        typedef vector<myContent*> type_bucket;
+        typedef unordered_map<RTTI::TypeID, type_bucket> type_index;
         
+        Arena                   mArena;         // contents made by emplaceContent and all records
         vector<myContent*>      mContents;
+        name_index              mNameIndex;
+        type_index              mTypeIndex;     // contents of each type in order of instances
+        
+        // slot map for handles, freed slots are recycled with a new generation
+        struct mySlot
+        {
+            myContent*          o;
+            uint32_t            generation;
+        };
+        vector<mySlot>          mSlots;
+        vector<uint32_t>        mFreeSlots;
+        
+        // parallel to mContents
+        vector<float>           mOpacities;
+        vector<uint8_t>         mFlags;
+        vector<RTTI::TypeID>    mTypeIDs;
+        vector<ofFbo*>          mFbos;
+        
+        // sorted indices of contents with opacity over zero
+        vector<int>             mVisible;
+        vector<int>             mUpdateOrder;
         
         ofFbo::Settings         mFboSettings;
         ofParameterGroup        mOpacityParams;
         bool                    bBackgroundUpdate;
+        bool                    bScheduledBackgroundUpdate;
+        float                   mBackgroundBudget;
+        vector<myContent*>      mBackgroundQueue;
         int                     mCurrentContent;
         
+        FboPool                 mFboPool;
+        bool                    bFboPool;
+        bool                    bFboPoolExhausted;  // warned, until an update leases without running out
+        bool                    bFboPoolFailed;     // ran out in this update
+        
+        Compositor              mCompositor;
+        bool                    bCompositor;
+        vector<ofTexture*>      mVisibleTextures;
+        vector<float>           mVisibleOpacities;
+        ofRectangle             mCompositeRect;     // where the batched layers are drawn
+        float                   mCompositeZ;
+        bool                    bPassThrough;
+        
+        WorkerPool              mWorkerPool;
+        bool                    bUpdateThreads;
+        vector<myContent*>      mThreadedUpdates;
+        function<void(int)>     mThreadedUpdateTask;
+        float                   mUpdateTime;
+        
+        StateGuard              mStateGuard;
+        
+        vector<myTransitionLayer> mTransitionLayers;
+        
+        bool                    bOpacityBatch;
+        vector<myContent*>      mOpacityDirty;
+        vector<myContent*>      mOpacityNotifying;
+        Loader                  mLoader;
+        bool                    bAsyncLoading;
+        deque<myContent*>       mSetupQueue;
+        float                   mSetupBudget;
+        
+        struct
+        {
+            bool                active;
+            bool                byName;
+            string              name;
+            myContent*          o;
+            float               duration;
+            Easing              easing;
+        } mPendingSwitch;
+        
+        deque<myContent*>       mPrewarmQueue;
+        float                   mPrewarmBudget;
+        
+        float                   mTransitionStart;
+        float                   mTransitionDuration;
+        Easing                  mTransitionEasing;
+        
+        ClockMode               mClockMode;
+        float                   mClockStep;
+        float                   mTime;
+        float                   mDeltaTime;
+        uint64_t                mFrameNum;
+        bool                    bClockStarted;
+        
+        Readback                mReadback;
+        bool                    bReadback;
+        ofFbo                   mOutputFbo;
+        
+        ImageSequenceWriter     mSequenceWriter;
+        bool                    bOfflineRender;
+        bool                    bOfflineReadback;   // readback was enabled by beginOfflineRender()
+        bool                    bOfflineDropFrames;
+        uint64_t                mOfflineFirstFrame;
+        uint64_t                mOfflineNumFrames;
+        ClockMode               mOfflineClockMode;
+        float                   mOfflineClockStep;
+        function<void(const ReadbackFrame&)> mOfflineCallback;
+        
+        bool                    bOcclusionCulling;
+        bool                    bUpdateOccluded;
+        vector<ofRectangle>     mOccluders;
+        
+        vector<Output*>         mOutputs;
+        vector<ContentHandle>   mOutputShown;       // contents with FLAG_OUTPUT
+        vector<ContentHandle>   mOutputShownPrevious;
+        vector<int>             mOutputLayers;
+        vector<float>           mOutputOpacities;   // parallel to mContents, overrides applied
+        
+        bool                    bProfiler;
+#if OFX_CONTENTS_MANAGER_PROFILER
+        RollingTimer            mCompositeTimer;
+        GpuTimer                mCompositeGpuTimer;
+        ofParameter<float>      mCompositeParam;
+        ofParameter<float>      mCompositeGpuParam;
+#endif
+        ofParameterGroup        mProfilerParams;
+        
     protected:
         bool isValid(const int nid);
         bool isValid(const string& name);
+        myContent* resolve(const ContentHandle& handle);
+        myContent* lookup(const ContentHandle& handle);    // resolve() without error, for handles kept across removals
+        void acquireSlot(myContent* o);
+        void releaseSlot(myContent* o);
+        
+        myContent* findContent(Content* obj);
+        void renameContent(Content* obj, const string& oldName, const string& newName);
+        void destroyContent(myContent* o);
+        void freeContent(myContent* o);
+        void eraseContent(const int index);
+        void syncOpacity(myContent* o);
+        void writeOpacity(myContent* o, const float opacity);
+        void notifyOpacity();
+        void setContentState(myContent* o, const ContentState newState);
+        
+        void allocateContentBuffer(myContent* o);
+        void reallocateContent(Content* obj);
+        void applyUpsampleFilter(Content* obj);
+        void resizeContent(Content* obj);
+        void applyBufferSize(Content* obj);
+        bool acquireBuffer(myContent* o);
+        void releaseBuffer(myContent* o);
+        void suspendContent(myContent* o);
+        void allocatePool();
+        void renderContent(myContent* o);
+        void warmContent(myContent* o);
+        bool isFlattened(const myContent* o) const { return o->group && !o->group->needsIsolation(); }
+        void updateContent(myContent* o, const float time);
+        bool isRenderDue(myContent* o, const float time);
+        void startLoading(myContent* o);
+        void updateLoading();
+        void updatePendingSwitch();
+        void updateBackground(const float time);
+        void updatePrewarm();
+        void beginTransition(const float duration, const Easing easing);
+        void updateTransition(const float time);
+        void cancelTransition(myContent* o);
+        ofRectangle getContentRect(myContent* o);
+        void updateOcclusion();
+        void drawContent(const int index, const float opacity, const ofColor& color, const float x, const float y, const float z, const float width, const float height);
+        void updateOutputs();
+        void buildOutputLayers(const Output* output);
+        void compositeOutputs();
+        void compositeOutput();
+        void updateClock();
+        void rebaseClock(const float time);
+        void writeOfflineFrame(const ReadbackFrame& frame);
+        void drawComposite(const float x, const float y, const float z, const float width, const float height);
+        void compositeContents(const float x, const float y, const float z, const float width, const float height);
+        void compositeLayers(const vector<int>& layers, const vector<float>& opacities, const bool culling, const float x, const float y, const float z, const float width, const float height);
+        void collectLayers(Manager* target, const vector<int>& layers, const vector<float>& opacities, const float groupOpacity, const bool culling, const ofColor& color, const float x, const float y, const float z, const float width, const float height, const bool batch);
+        void flushLayers();
+        void updateProfiler();
         
     public:
         
@@ -179,39 +639,147 @@ namespace ofxContentsManager
         void setOpacity(const string& name, const float opacity);
         
         /**
-         *  Set the all content's opacity
+         *  Set the content's opacity
+         *
+         *  @param handle  Target content's handle
+         *  @param opacity Opacity (0.0-1.0)
+         */
+        void setOpacity(const ContentHandle& handle, const float opacity);
+        
+        /**
+         *  Set the all content's opacity, listeners are notified in next update() only for changed contents
          *
          *  @param opacity Opacity (0.0-1.0)
          */
         void setOpacityAll(const float opacity);
         
         /**
-         *  Switching content
+         *  Set opacities of contents in order of instances at once,
+         *  listeners are notified in next update() only for changed contents
+         *
+         *  @param opacities Opacities (0.0-1.0), extra values are ignored
+         */
+        void setOpacities(const vector<float>& opacities);
+        
+        /**
+         *  Begin opacity batch, setOpacity() calls until commitOpacityBatch() are applied
+         *  without notification. switchContent() and setOpacityAll() always work this way.
+         */
+        void beginOpacityBatch() { bOpacityBatch = true; }
+        
+        /**
+         *  End opacity batch, listeners (Content::opacityChanged(), GUI) are notified in next update(),
+         *  once per content and only when the value differs from the last notified one
+         */
+        void commitOpacityBatch() { bOpacityBatch = false; }
+        
+        /**
+         *  Switching content, with crossfade when duration is over zero.
+         *  The crossfade is driven by update() and touches only fading layers.
+         *  Opacity listeners of changed contents are notified once in update(), after a cut
+         *  or when the crossfade finished.
          *
-         *  @param nid Target constnt's ID (order of instances)
+         *  @param nid      Target constnt's ID (order of instances)
+         *  @param duration Crossfade duration in seconds (default = 0, cut)
+         *  @param easing   Crossfade easing curve (default = EASE_LINEAR)
          */
-        void switchContent(const int nid);
+        void switchContent(const int nid, const float duration = 0, const Easing easing = EASE_LINEAR);
         
         /**
          *  Switching consent
          *
-         *  @param name Target content's name
+         *  @param name     Target content's name
+         *  @param duration Crossfade duration in seconds (default = 0, cut)
+         *  @param easing   Crossfade easing curve (default = EASE_LINEAR)
          */
-        void switchContent(const string& name);
+        void switchContent(const string& name, const float duration = 0, const Easing easing = EASE_LINEAR);
+        
+        /**
+         *  Switching content
+         *
+         *  @param handle   Target content's handle
+         *  @param duration Crossfade duration in seconds (default = 0, cut)
+         *  @param easing   Crossfade easing curve (default = EASE_LINEAR)
+         */
+        void switchContent(const ContentHandle& handle, const float duration = 0, const Easing easing = EASE_LINEAR);
         
         /**
          *  Switching next content
          *
-         *  @param loop Is go back to first (default = false)
+         *  @param loop     Is go back to first (default = false)
+         *  @param duration Crossfade duration in seconds (default = 0, cut)
+         *  @param easing   Crossfade easing curve (default = EASE_LINEAR)
          */
-        void switchNextContent(bool loop = false);
+        void switchNextContent(bool loop = false, const float duration = 0, const Easing easing = EASE_LINEAR);
         
         /**
          *  Switching previous content
          *
-         *  @param loop Is go back to last (default = false)
+         *  @param loop     Is go back to last (default = false)
+         *  @param duration Crossfade duration in seconds (default = 0, cut)
+         *  @param easing   Crossfade easing curve (default = EASE_LINEAR)
+         */
+        void switchPreviousContent(bool loop = false, const float duration = 0, const Easing easing = EASE_LINEAR);
+        
+        /**
+         *  Setting async loading, Content::load() of new contents run on a loader thread and
+         *  Content::setupGL() run in upcoming updates within the setup budget.
+         *  Contents are not updated, drawn or switched to until ready.
+         *  Removing a content while its load() is running blocks until load() returns.
+         *  (default is disable, load() and setupGL() are called in addContent)
+         *
+         *  @param enable true or false
+         */
+        void enableAsyncLoading(bool enable) { bAsyncLoading = enable; }
+        
+        /**
+         *  Setting time budget per update for Content::setupGL(), at least one content is setup per update
+         *
+         *  @param milliseconds Budget (default = 4)
          */
-        void switchPreviousContent(bool loop = false);
+        void setSetupBudget(const float milliseconds) { mSetupBudget = milliseconds; }
+        
+        /**
+         *  Render the content offscreen once in upcoming updates, to pay for first-draw costs
+         *  (shader compile, VBO, font atlas, first fbo.begin()) before it becomes visible.
+         *  A pass-through group also prewarms its hidden members, it is warm when all of them are.
+         *
+         *  @param nid Target content's ID (order of instances)
+         */
+        void prewarm(const int nid);
+        
+        /**
+         *  Render contents offscreen once in upcoming updates
+         *
+         *  @param name Target content's name
+         */
+        void prewarm(const string& name);
+        
+        /**
+         *  Render all of contents not rendered yet offscreen once in upcoming updates
+         */
+        void prewarmAll();
+        
+        /**
+         *  Setting time budget per update for prewarm, at least one content is rendered per update
+         *
+         *  @param milliseconds Budget (default = 4)
+         */
+        void setPrewarmBudget(const float milliseconds) { mPrewarmBudget = milliseconds; }
+        
+        /**
+         *  Offer number of contents waiting for prewarm
+         *
+         *  @return number
+         */
+        int getNumPendingPrewarm() const { return mPrewarmQueue.size(); }
+        
+        /**
+         *  Offer is crossfade running
+         *
+         *  @return true or false
+         */
+        bool isTransitioning() const { return !mTransitionLayers.empty(); }
         
         /**
          *  Setting background update flag, set true if you need update all contents even opacity zero.
@@ -221,12 +789,247 @@ namespace ofxContentsManager
          */
         void enableBackgroundUpdate(bool enable);
         
+        /**
+         *  Setting scheduled background update, contents with opacity zero are updated within a time budget
+         *  per update, stalest first weighted by Content::setBackgroundPriority(), after all visible contents.
+         *  Frame buffers are re-rendered too unless the FBO pool is enabled.
+         *  Ignored while enableBackgroundUpdate(true). (default is disable)
+         *
+         *  @param enable       true or false
+         *  @param milliseconds Budget per update (default = 2)
+         */
+        void enableScheduledBackgroundUpdate(bool enable, const float milliseconds = 2);
+        
+        /**
+         *  Offer time since the content was last updated
+         *
+         *  @param nid Target content's ID (order of instances)
+         *
+         *  @return seconds
+         */
+        float getStaleness(const int nid);
+        
+        /**
+         *  Setting pooled frame buffer mode, contents lease a frame buffer from a shared pool
+         *  only while opacity is over zero (or background update is enabled), so hidden contents hold no GPU memory.
+         *  (default is disable)
+         *
+         *  @param enable   true or false
+         *  @param maxFbos  Maximum number of frame buffers in the pool (default = 4)
+         */
+        void enableFboPool(bool enable, const int maxFbos = 4);
+        
+        /**
+         *  Offer frame buffer pool
+         *
+         *  @return FboPool reference
+         */
+        const FboPool& getFboPool() const { return mFboPool; }
+        
+        /**
+         *  Setting compositor mode, visible contents are blended in a single shader pass
+         *  (per number of texture units) instead of drawing each content's frame buffer.
+         *  Require GL context. (default is disable)
+         *
+         *  @param enable           true or false
+         *  @param maxLayersPerPass Maximum layers blended in one pass (default = 0, number of texture units)
+         */
+        void enableCompositor(bool enable, const int maxLayersPerPass = 0);
+        
+        /**
+         *  Setting occlusion culling, contents completely hidden beneath contents declared
+         *  Content::setOpaque() at opacity 1 are not rendered and composited.
+         *  Assume draw() of the manager is called with opaque color. (default is disable)
+         *
+         *  @param enable           true or false
+         *  @param updateOccluded   Keep calling update() of hidden contents (default = false)
+         */
+        void enableOcclusionCulling(bool enable, bool updateOccluded = false);
+        
+        /**
+         *  Setting update threads, update() of contents declared setUpdateThreadSafe(true) run on
+         *  a worker pool before the serial render pass. (default is disable)
+         *
+         *  @param enable       true or false
+         *  @param numThreads   Number of worker threads (default = 0, hardware concurrency - 1)
+         */
+        void enableUpdateThreads(bool enable, const int numThreads = 0);
+        
+        /**
+         *  Setting profiler, record CPU time of update() and draw(), GPU time of rendering and compositing.
+         *  Available when OFX_CONTENTS_MANAGER_PROFILER is 1. (default is disable)
+         *
+         *  @param enable true or false
+         */
+        void enableProfiler(bool enable);
+        
+        /**
+         *  Offer the content's timing statistics
+         *
+         *  @param nid Target content's ID (order of instance)
+         *
+         *  @return ContentStats
+         */
+        ContentStats getContentStats(const int nid);
+        
+        /**
+         *  Offer CPU timing statistics of draw() (compositing)
+         *
+         *  @return TimingStats
+         */
+        TimingStats getCompositeStats() const;
+        
+        /**
+         *  Offer GPU timing statistics of draw() (compositing)
+         *
+         *  @return TimingStats
+         */
+        TimingStats getCompositeGpuStats() const;
+        
+        /**
+         *  Offer profiler's parameter group, average milliseconds of each content
+         *
+         *  @param groupName    Parameter group name (default is "PROFILER")
+         *
+         *  @return             ofParameterGroup reference
+         */
+        const ofParameterGroup& getProfilerParameterGroup(const string& groupName = "PROFILER");
+        
+        /**
+         *  Setting output readback, contents are composited into a manager-owned frame buffer in update()
+         *  and read back through a ring of pixel buffer objects without stalling, draw() shows that frame buffer.
+         *  Finished frames go to Readback::setCallback() and Readback::openSharedMemory() within (numBuffers - 1) updates.
+         *  Require GL context. (default is disable)
+         *
+         *  @param enable       true or false
+         *  @param numBuffers   Number of pixel buffer objects, frames in flight (default = 3)
+         */
+        void enableReadback(bool enable, const int numBuffers = 3);
+        
+        /**
+         *  Offer readback, to set callback, shared memory and read counters
+         *
+         *  @return Readback reference
+         */
+        Readback& getReadback() { return mReadback; }
+        
+        /**
+         *  Offer composited output, available when readback is enabled
+         *
+         *  @return ofTexture reference
+         */
+        ofTexture& getOutputTexture();
+        
+        /**
+         *  Add output target, each update() composites its layers into its own frame buffer
+         *  from the contents' frame buffers rendered once for all outputs.
+         *  Outputs smaller than the manager's buffer are reduced through a downsample chain.
+         *  Contents shown in an output are not culled by occlusion culling.
+         *  Require GL context.
+         *
+         *  @param name     Output name, an existing output of the name is reallocated
+         *  @param width    Output width
+         *  @param height   Output height
+         *
+         *  @return Output reference, to set layers and opacity overrides and to draw
+         */
+        Output& addOutput(const string& name, const int width, const int height);
+        
+        /**
+         *  Offer output target
+         *
+         *  @param name Output name
+         *
+         *  @return Output pointer (NULL when not found)
+         */
+        Output* getOutput(const string& name);
+        Output* getOutput(const int index) { return index >= 0 && index < mOutputs.size() ? mOutputs[index] : NULL; }
+        int getNumOutputs() const { return mOutputs.size(); }
+        
+        /**
+         *  Remove output target
+         *
+         *  @param name Output name
+         */
+        void removeOutput(const string& name);
+        
+        /**
+         *  Setting pass-through compositing, used when this manager is nested in another manager as a group.
+         *  The parent composites this manager's layers directly into its own output with this manager's opacity
+         *  multiplied into each layer, instead of drawing them into this manager's frame buffer first.
+         *  While the group is faded, its overlapping translucent layers show through each other.
+         *  (default is disable)
+         *
+         *  @param enable true or false
+         */
+        void setPassThrough(bool enable) { bPassThrough = enable; }
+        bool isPassThrough() const { return bPassThrough; }
+        
+        /**
+         *  Offer whether the parent needs a frame buffer for this manager, it is true unless pass-through is enabled,
+         *  or when resolution scale, render size, render rate or render cache is set
+         *
+         *  @return true or false
+         */
+        bool needsIsolation() const;
+        
+        /**
+         *  Setting time source of contents' getTime(), getDeltaTime() and getFrameNum(),
+         *  render rates, update rates and transitions. The clock restarts, current timings are kept.
+         *  Nested managers follow the parent manager's clock.
+         *  (default is CLOCK_MODE_REALTIME)
+         *
+         *  @param mode CLOCK_MODE_REALTIME or CLOCK_MODE_FIXED_STEP
+         *  @param fps  Steps per second of CLOCK_MODE_FIXED_STEP (default = 60)
+         */
+        void setClock(ClockMode mode, const float fps = 60);
+        ClockMode getClockMode() const { return mClockMode; }
+        
+        /**
+         *  Offer the manager's clock, same as contents see
+         */
+        float getTime() const { return mTime; }
+        float getDeltaTime() const { return mDeltaTime; }
+        uint64_t getFrameNum() const { return mFrameNum; }
+        
+        /**
+         *  Start offline rendering, each update() advances the clock by 1 / fps and the composited output
+         *  is saved into an image sequence (directory/frame_000000.png, ...) through readback without dropping frames.
+         *  update() waits for the GPU and the writer thread instead of the display, so disable vertical sync
+         *  and frame rate limit (ofSetVerticalSync(false), ofSetFrameRate(0)) to render as fast as possible.
+         *  Time budgets (background update, setup, prewarm) stay in wall-clock time.
+         *  Require GL context.
+         *
+         *  @param directory    Output directory, relative to data path
+         *  @param fps          Frames per second of the sequence (default = 60)
+         *  @param numFrames    Stop automatically after this number of frames (0 = until endOfflineRender(), default)
+         *  @param extension    Lossless image format, "png" (default), "tif", "tiff" or "bmp", others are rejected
+         *
+         *  @return is start succeed
+         */
+        bool beginOfflineRender(const string& directory, const float fps = 60, const int numFrames = 0, const string& extension = "png");
+        
+        /**
+         *  Stop offline rendering, wait for all frames to be saved and restore clock and readback
+         */
+        void endOfflineRender();
+        bool isOfflineRendering() const { return bOfflineRender; }
+        
+        /**
+         *  Offer number of frames saved by the current or last offline rendering
+         *
+         *  @return number of frames
+         */
+        uint64_t getNumOfflineFrames() const { return mSequenceWriter.getNumWritten(); }
+        
         /**
          *  Add content
          *
          *  @param o New content pointer
+         *
+         *  @return New content's handle
          */
-        void addContent(Content* newContentPtr);
+        ContentHandle addContent(Content* newContentPtr);
         
         /**
          *  Remove content
@@ -244,6 +1047,43 @@ namespace ofxContentsManager
          */
         void removeContent(const string& name);
         
+        /**
+         *  Remove content
+         *
+         *  @param handle Target content's handle
+         *
+         *  @return is remove succeed
+         */
+        bool removeContent(const ContentHandle& handle);
+        
+        /**
+         *  Offer is the handle refer to a content in this manager, O(1)
+         *
+         *  @param handle Target content's handle
+         *
+         *  @return true or false
+         */
+        bool contains(const ContentHandle& handle) const;
+        
+        /**
+         *  Offer the content's handle
+         *
+         *  @param nid Target content's ID (order of instance)
+         *
+         *  @return ContentHandle (null handle when the ID is invalid)
+         */
+        ContentHandle getHandle(const int nid);
+        using Content::getHandle;
+        
+        /**
+         *  Offer the content's current ID (order of instance)
+         *
+         *  @param handle Target content's handle
+         *
+         *  @return ID, -1 when the handle is invalid
+         */
+        int getIndex(const ContentHandle& handle) const;
+        
         /**
          *  Offer number of contents
          *
@@ -274,6 +1114,15 @@ namespace ofxContentsManager
          */
         Content* getContent(const int nid);
         
+        /**
+         *  Offer the content referred by the handle
+         *
+         *  @param handle Target content's handle
+         *
+         *  @return Pointer as ofxContentsManager::Content, NULL when the handle is invalid
+         */
+        Content* getContent(const ContentHandle& handle);
+        
         /**
          *  Offer the all of contents
          *
@@ -285,137 +1134,101 @@ namespace ofxContentsManager
         
         
         /**
-         *  Add new content, <br/>
-         *  e.g. addContent<MyContentClassName>("constoructor_argument_1", "constoructor_argument_2". ...)
+         *  Construct new content in the manager's arena, arguments are perfectly forwarded
+         *  (move-only and large arguments are not copied) <br/>
+         *  e.g. emplaceContent<MyContentClassName>(std::move(pixels), "constoructor_argument_2", ...)
          *
          *  @return New content's pointer
          */
-        
-        template <typename T>
-        T* addContent()
-        {
-            return setupContent(new T);
-        }
-        
-        template <typename T, typename A0>
-        T* addContent(const A0& a0)
-        {
-            return setupContent<T>(new T(a0));
-        }
-        
-        template <typename T, typename A0, typename A1>
-        T* addContent(const A0& a0, const A1& a1)
-        {
-            return setupContent<T>(new T(a0, a1));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2)
-        {
-            return setupContent<T>(new T(a0, a1, a2));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7, a8));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9, const A10& a10)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9, const A10& a10, const A11& a11)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11));
-        }
-        
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11, typename A12>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9, const A10& a10, const A11& a11, const A12& a12)
+        template <typename T, typename... Args>
+        T* emplaceContent(Args&&... args)
         {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12));
+            void* memory = mArena.allocate(sizeof(T), alignof(T));
+            T* newContentPtr;
+            try
+            {
+                newContentPtr = new (memory) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                mArena.deallocate(memory, sizeof(T), alignof(T));
+                throw;
+            }
+            return setupContent<T>(newContentPtr, memory, sizeof(T), alignof(T));
         }
         
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11, typename A12, typename A13>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9, const A10& a10, const A11& a11, const A12& a12, const A13& a13)
+        /**
+         *  Add new content, <br/>
+         *  e.g. addContent<MyContentClassName>("constoructor_argument_1", "constoructor_argument_2". ...)
+         *
+         *  @return New content's pointer
+         */
+        template <typename T, typename... Args>
+        T* addContent(const Args&... args)
         {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13));
+            return emplaceContent<T>(args...);
         }
         
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11, typename A12, typename A13, typename A14>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9, const A10& a10, const A11& a11, const A12& a12, const A13& a13, const A14& a14)
+        template <typename T>
+        void removeContent()
         {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14));
+            type_index::iterator found = mTypeIndex.find(RTTI::getTypeID<T>());
+            if (found == mTypeIndex.end()) return;
+            while (!found->second.empty())
+            {
+                eraseContent(found->second.back()->index);
+            }
         }
         
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11, typename A12, typename A13, typename A14, typename A15>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9, const A10& a10, const A11& a11, const A12& a12, const A13& a13, const A14& a14, const A15& a15)
-        {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15));
-        }
-
-        template <typename T, typename A0, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11, typename A12, typename A13, typename A14, typename A15, typename A16>
-        T* addContent(const A0& a0, const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5, const A6& a6, const A7& a7, const A8& a8, const A9& a9, const A10& a10, const A11& a11, const A12& a12, const A13& a13, const A14& a14, const A15& a15, const A16& a16)
+        /**
+         *  Non-allocating range of contents of a type, in order of instances.
+         *  Valid until a content of the type is added or removed.
+         */
+        template <typename T>
+        class ContentView
         {
-            return setupContent<T>(new T(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15, a16));
-        }
+        public:
+            class iterator
+            {
+            public:
+                typedef forward_iterator_tag    iterator_category;
+                typedef T*                      value_type;
+                typedef ptrdiff_t               difference_type;
+                typedef T**                     pointer;
+                typedef T*                      reference;
+                
+                explicit iterator(type_bucket::const_iterator it) : it(it) {}
+                T* operator*() const { return static_cast<T*>((*it)->obj); }
+                iterator& operator++() { ++it; return *this; }
+                bool operator==(const iterator& rhs) const { return it == rhs.it; }
+                bool operator!=(const iterator& rhs) const { return it != rhs.it; }
+            private:
+                type_bucket::const_iterator it;
+            };
+            
+            explicit ContentView(const type_bucket& bucket) : bucket(bucket) {}
+            iterator begin() const { return iterator(bucket.begin()); }
+            iterator end() const { return iterator(bucket.end()); }
+            size_t size() const { return bucket.size(); }
+            bool empty() const { return bucket.empty(); }
+            T* operator[](size_t i) const { return static_cast<T*>(bucket[i]->obj); }
+            
+        private:
+            const type_bucket& bucket;
+        };
         
+        /**
+         *  Offer contents of your requested type without allocation, O(1) <br/>
+         *  e.g. for (MyContentClassName* c : manager.getContentView<MyContentClassName>()) { ... }
+         *
+         *  @return ContentView
+         */
         template <typename T>
-        void removeContent()
+        ContentView<T> getContentView() const
         {
-            typename vector<myContent*>::iterator it = mContents.begin();
-            while (it != mContents.end())
-            {
-                myContent *o = *it;
-                if (o->typeID == RTTI::getTypeID<T>())
-                {
-                    o->obj->exit();
-                    o->opacity.removeListener(o->obj, &Content::onOpacityChanged);
-                    delete o->obj;
-                    delete o;
-                    it = mContents.erase(it);
-                }
-                else ++it;
-            }
+            static const type_bucket empty;
+            type_index::const_iterator found = mTypeIndex.find(RTTI::getTypeID<T>());
+            return ContentView<T>(found == mTypeIndex.end() ? empty : found->second);
         }
         
         /**
@@ -426,36 +1239,47 @@ namespace ofxContentsManager
         template <typename T>
         vector<T*> getContents()
         {
-            vector<T*> result;
-            
-            typename vector<myContent*>::iterator it = mContents.begin();
-            while (it != mContents.end())
-            {
-                myContent *o = *it;
-                if (o->typeID == RTTI::getTypeID<T>())
-                {
-                    result.push_back((T*)o);
-                }
-                it++;
-            }
-            
-            return result;
+            ContentView<T> view = getContentView<T>();
+            return vector<T*>(view.begin(), view.end());
         }
         
     protected:
         
         template <typename T>
-        T* setupContent(T* newContentPtr)
+        T* setupContent(T* newContentPtr, void* memory = NULL, const size_t size = 0, const size_t alignment = 0)
         {
-            mContents.push_back(new myContent());
-            myContent* o = mContents.back();
+            myContent* o = new (mArena.allocate(sizeof(myContent), alignof(myContent))) myContent();
+            o->manager = this;
+            o->index = mContents.size();
             o->obj = newContentPtr;
-            o->obj->bufferWidth =  mFboSettings.width;
-            o->obj->bufferHeight = mFboSettings.height;
-            o->fbo.allocate(mFboSettings);
-            o->typeID = RTTI::getTypeID<T>();
-            mOpacityParams.add(o->opacity.set(o->obj->getName(), 0.0, 0.0, 1.0));
+            o->group = dynamic_cast<Manager*>(o->obj);
+            o->objMemory = memory;
+            o->objSize = size;
+            o->objAlignment = alignment;
+            mContents.push_back(o);
+            mOpacities.push_back(0.0);
+            mFlags.push_back(0);
+            mTypeIDs.push_back(RTTI::getTypeID<T>());
+            mTypeIndex[RTTI::getTypeID<T>()].push_back(o);
+            mFbos.push_back(NULL);
+            o->notifiedOpacity = 0.0;
+            o->bOpacityDirty = false;
+            acquireSlot(o);
+            applyBufferSize(o->obj);
+            if (!bFboPool && !isFlattened(o)) allocateContentBuffer(o);
+            o->obj->parentManager = this;
+            const string& name = o->obj->getName();
+            mNameIndex.insert(make_pair(name, o));
+            mOpacityParams.add(o->opacity.set(name, 0.0, 0.0, 1.0));
+            o->opacity.addListener(o, &myContent::onOpacityChanged); // hot data first, so the content sees it updated
             o->opacity.addListener(o->obj, &Content::onOpacityChanged);
+            startLoading(o);
+#if OFX_CONTENTS_MANAGER_PROFILER
+            o->profileParams.setName(name);
+            o->profileParams.add(o->updateParam.set("update ms", 0.0, 0.0, 33.3));
+            o->profileParams.add(o->drawParam.set("draw ms", 0.0, 0.0, 33.3));
+            o->profileParams.add(o->gpuParam.set("gpu ms", 0.0, 0.0, 33.3));
+#endif
             return newContentPtr;
         }
     };
@@ -0,0 +1,102 @@
+#include "ofxContentsManagerArena.h"
+
+namespace
+{
+    const size_t MIN_ALIGNMENT = alignof(max_align_t);
+    
+    size_t roundUp(const size_t value, const size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+namespace ofxContentsManager
+{
+    Arena::Arena(const size_t blockSize)
+    : mBlockSize(blockSize)
+    , mCurrentBlock(0)
+    , mOffset(0)
+    , mBytesInUse(0)
+    {
+    }
+    
+    Arena::~Arena()
+    {
+        reset();
+        for (auto& block : mBlocks)
+        {
+            delete[] block.data;
+        }
+    }
+    
+    void* Arena::allocate(const size_t size, const size_t alignment)
+    {
+        const size_t align = max(alignment, MIN_ALIGNMENT);
+        const size_t bytes = roundUp(max(size, (size_t)1), align);
+        
+        vector<void*>& freeList = mFreeLists[bytes];
+        if (!freeList.empty() && (uintptr_t)freeList.back() % align == 0)
+        {
+            void* p = freeList.back();
+            freeList.pop_back();
+            mBytesInUse += bytes;
+            return p;
+        }
+        
+        if (bytes + align > mBlockSize)
+        {
+            Block block = { new char[bytes + align], bytes + align };
+            mLargeBlocks.push_back(block);
+            mBytesInUse += bytes;
+            return (void*)roundUp((uintptr_t)block.data, align);
+        }
+        
+        for (;;)
+        {
+            if (mCurrentBlock == mBlocks.size())
+            {
+                Block block = { new char[mBlockSize], mBlockSize };
+                mBlocks.push_back(block);
+            }
+            const Block& block = mBlocks[mCurrentBlock];
+            const uintptr_t p = roundUp((uintptr_t)block.data + mOffset, align);
+            if (p + bytes <= (uintptr_t)block.data + block.size)
+            {
+                mOffset = p + bytes - (uintptr_t)block.data;
+                mBytesInUse += bytes;
+                return (void*)p;
+            }
+            ++mCurrentBlock;
+            mOffset = 0;
+        }
+    }
+    
+    void Arena::deallocate(void* p, const size_t size, const size_t alignment)
+    {
+        if (p == NULL) return;
+        const size_t bytes = roundUp(max(size, (size_t)1), max(alignment, MIN_ALIGNMENT));
+        mFreeLists[bytes].push_back(p);
+        mBytesInUse -= bytes;
+    }
+    
+    void Arena::reset()
+    {
+        mFreeLists.clear();
+        for (auto& block : mLargeBlocks)
+        {
+            delete[] block.data;
+        }
+        mLargeBlocks.clear();
+        mCurrentBlock = 0;
+        mOffset = 0;
+        mBytesInUse = 0;
+    }
+    
+    size_t Arena::getBytesReserved() const
+    {
+        size_t bytes = 0;
+        for (auto& block : mBlocks) bytes += block.size;
+        for (auto& block : mLargeBlocks) bytes += block.size;
+        return bytes;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ofMain.h"
+
+namespace ofxContentsManager
+{
+    //---------------------------------------------------------------------------------------
+    /*
+        ARENA CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    class Arena
+    {
+        struct Block
+        {
+            char*           data;
+            size_t          size;
+        };
+        
+        vector<Block>       mBlocks;
+        vector<Block>       mLargeBlocks;
+        unordered_map<size_t, vector<void*> > mFreeLists;
+        size_t              mBlockSize;
+        size_t              mCurrentBlock;
+        size_t              mOffset;
+        size_t              mBytesInUse;
+        
+    public:
+        /**
+         *  Constractor
+         *
+         *  @param blockSize Bytes of each memory block (default = 64KB)
+         */
+        Arena(const size_t blockSize = 64 * 1024);
+        virtual ~Arena();
+        
+        /**
+         *  Allocate memory, a deallocated chunk of the same size is reused first.
+         *  Chunks larger than the block size get a dedicated block.
+         *
+         *  @param size         Bytes
+         *  @param alignment    Alignment (at least alignof(max_align_t) is given)
+         *
+         *  @return Pointer to uninitialized memory
+         */
+        void* allocate(const size_t size, const size_t alignment);
+        
+        /**
+         *  Give back memory offered from allocate(), the object must be destroyed already
+         *
+         *  @param p            Pointer offered from allocate()
+         *  @param size         Same bytes as allocate()
+         *  @param alignment    Same alignment as allocate()
+         */
+        void deallocate(void* p, const size_t size, const size_t alignment);
+        
+        /**
+         *  Rewind all blocks for reuse, memory offered from allocate() become invalid.
+         *  Call it only after every object in the arena is destroyed.
+         */
+        void reset();
+        
+        size_t getBytesInUse() const { return mBytesInUse; }
+        size_t getBytesReserved() const;
+        int getNumBlocks() const { return mBlocks.size() + mLargeBlocks.size(); }
+    };
+}
@@ -0,0 +1,181 @@
+#include "ofxContentsManagerCompositor.h"
+
+static const string MODULE_NAME = "ofxContentsManager::Compositor";
+
+// upper limit of generated sampler uniforms, most GL2 drivers offer 16 fragment texture units
+static const int MAX_TEXTURE_UNITS = 16;
+
+namespace ofxContentsManager
+{
+    Compositor::Compositor()
+    : mTextureTarget(GL_TEXTURE_2D)
+    , mMaxLayers(1)
+    , bSetup(false)
+    {
+    }
+    
+    bool Compositor::setup(const GLenum textureTarget, const int maxLayers)
+    {
+        GLint units = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &units);
+        units = ofClamp(units, 1, MAX_TEXTURE_UNITS);
+        
+        mTextureTarget = textureTarget;
+        mMaxLayers = maxLayers > 0 ? min(maxLayers, (int)units) : units;
+        
+        mUniformNames.clear();
+        for (int i = 0; i < mMaxLayers; ++i)
+        {
+            mUniformNames.push_back("layer" + ofToString(i));
+        }
+        mOpacities.assign(mMaxLayers, 0.0);
+        mTexScales.assign(mMaxLayers * 2, 1.0);
+        
+        mShader = ofShader();
+        bSetup = mShader.setupShaderFromSource(GL_VERTEX_SHADER, getShaderSource(GL_VERTEX_SHADER))
+              && mShader.setupShaderFromSource(GL_FRAGMENT_SHADER, getShaderSource(GL_FRAGMENT_SHADER));
+        if (bSetup)
+        {
+            if (ofIsGLProgrammableRenderer()) mShader.bindDefaults();
+            bSetup = mShader.linkProgram();
+        }
+        if (!bSetup)
+        {
+            ofLogError(MODULE_NAME) << "failed to compile compositor shader";
+        }
+        return bSetup;
+    }
+    
+    string Compositor::getShaderSource(GLenum shaderType) const
+    {
+        const bool programmable = ofIsGLProgrammableRenderer();
+        const bool rect = mTextureTarget != GL_TEXTURE_2D;
+        const string sampler = rect ? "sampler2DRect" : "sampler2D";
+        const string lookup = programmable ? "texture" : (rect ? "texture2DRect" : "texture2D");
+        
+        stringstream ss;
+        if (shaderType == GL_VERTEX_SHADER)
+        {
+            if (programmable)
+            {
+                ss << "#version 150\n"
+                   << "uniform mat4 modelViewProjectionMatrix;\n"
+                   << "in vec4 position;\n"
+                   << "in vec2 texcoord;\n"
+                   << "out vec2 texCoordVarying;\n"
+                   << "void main() {\n"
+                   << "    texCoordVarying = texcoord;\n"
+                   << "    gl_Position = modelViewProjectionMatrix * position;\n"
+                   << "}\n";
+            }
+            else
+            {
+                ss << "#version 120\n"
+                   << "varying vec2 texCoordVarying;\n"
+                   << "void main() {\n"
+                   << "    texCoordVarying = gl_MultiTexCoord0.xy;\n"
+                   << "    gl_Position = ftransform();\n"
+                   << "}\n";
+            }
+            return ss.str();
+        }
+        
+        // layers are blended with "over" into premultiplied color, drawn with glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)
+        if (programmable)
+        {
+            ss << "#version 150\n"
+               << "in vec2 texCoordVarying;\n"
+               << "out vec4 outputColor;\n";
+        }
+        else
+        {
+            ss << "#version 120\n"
+               << (rect ? "#extension GL_ARB_texture_rectangle : enable\n" : "")
+               << "varying vec2 texCoordVarying;\n";
+        }
+        for (int i = 0; i < mMaxLayers; ++i)
+        {
+            ss << "uniform " << sampler << " " << mUniformNames[i] << ";\n";
+        }
+        ss << "uniform float opacity[" << mMaxLayers << "];\n"
+           << "uniform vec2 texScale[" << mMaxLayers << "];\n"
+           << "uniform int numLayers;\n"
+           << "uniform vec4 tint;\n"
+           << "void main() {\n"
+           << "    vec3 color = vec3(0.0);\n"
+           << "    float transmittance = 1.0;\n"
+           << "    vec4 c;\n"
+           << "    float a;\n";
+        for (int i = 0; i < mMaxLayers; ++i)
+        {
+            ss << "    if (numLayers > " << i << ") {\n"
+               << "        c = " << lookup << "(" << mUniformNames[i] << ", texCoordVarying * texScale[" << i << "]);\n"
+               << "        a = c.a * opacity[" << i << "] * tint.a;\n"
+               << "        color = c.rgb * tint.rgb * a + color * (1.0 - a);\n"
+               << "        transmittance *= 1.0 - a;\n"
+               << "    }\n";
+        }
+        ss << "    " << (programmable ? "outputColor" : "gl_FragColor") << " = vec4(color, 1.0 - transmittance);\n"
+           << "}\n";
+        return ss.str();
+    }
+    
+    void Compositor::draw(const vector<ofTexture*>& layers, const vector<float>& opacities, const float x, const float y, const float z, const float width, const float height)
+    {
+        if (layers.empty()) return;
+        
+        const ofColor color = ofGetStyle().color;
+        
+        // direct blit, nothing to blend
+        if (layers.size() == 1 && opacities[0] >= 1.0)
+        {
+            layers[0]->draw(x, y, z, width, height);
+            return;
+        }
+        
+        if (!bSetup)
+        {
+            ofLogError(MODULE_NAME) << "compositor is not setup";
+            return;
+        }
+        
+        ofPushStyle();
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        mShader.begin();
+        for (int first = 0; first < layers.size(); first += mMaxLayers)
+        {
+            const int count = min(mMaxLayers, (int)layers.size() - first);
+            drawPass(layers, opacities, first, count, color, x, y, z, width, height);
+        }
+        mShader.end();
+        ofPopStyle();
+    }
+    
+    void Compositor::drawPass(const vector<ofTexture*>& layers, const vector<float>& opacities, const int first, const int count, const ofColor& color, const float x, const float y, const float z, const float width, const float height)
+    {
+        // texture coordinates come from the first layer, scale them for layers of other sizes
+        const ofTextureData& base = layers[first]->getTextureData();
+        for (int i = 0; i < count; ++i)
+        {
+            const ofTextureData& data = layers[first + i]->getTextureData();
+            mShader.setUniformTexture(mUniformNames[i], *layers[first + i], i);
+            mOpacities[i] = opacities[first + i];
+            mTexScales[i * 2] = data.tex_t / base.tex_t;
+            mTexScales[i * 2 + 1] = data.tex_u / base.tex_u;
+        }
+        mShader.setUniform1fv("opacity", &mOpacities[0], mMaxLayers);
+        mShader.setUniform2fv("texScale", &mTexScales[0], mMaxLayers);
+        mShader.setUniform1i("numLayers", count);
+        mShader.setUniform4f("tint", color.r / ofColor::limit(), color.g / ofColor::limit(), color.b / ofColor::limit(), color.a / ofColor::limit());
+        
+        // the first layer provides the quad and texture coordinates
+        layers[first]->draw(x, y, z, width, height);
+        
+        for (int i = count - 1; i >= 0; --i)
+        {
+            glActiveTexture(GL_TEXTURE0 + i);
+            glBindTexture(mTextureTarget, 0);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ofMain.h"
+
+namespace ofxContentsManager
+{
+    //---------------------------------------------------------------------------------------
+    /*
+        LAYER COMPOSITOR CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    class Compositor
+    {
+        ofShader            mShader;
+        vector<string>      mUniformNames;
+        vector<float>       mOpacities;
+        vector<float>       mTexScales;
+        GLenum              mTextureTarget;
+        int                 mMaxLayers;
+        bool                bSetup;
+        
+        string getShaderSource(GLenum shaderType) const;
+        void drawPass(const vector<ofTexture*>& layers, const vector<float>& opacities, const int first, const int count, const ofColor& color, const float x, const float y, const float z, const float width, const float height);
+        
+    public:
+        Compositor();
+        virtual ~Compositor(){}
+        
+        /**
+         *  Setup compositor, require GL context
+         *
+         *  @param textureTarget    Texture target of layer's frame buffer (GL_TEXTURE_2D or GL_TEXTURE_RECTANGLE_ARB)
+         *  @param maxLayers        Maximum layers blended in one pass (0 = number of available texture units)
+         *
+         *  @return is shader compile succeed
+         */
+        bool setup(const GLenum textureTarget, const int maxLayers = 0);
+        
+        bool isSetup() const { return bSetup; }
+        GLenum getTextureTarget() const { return mTextureTarget; }
+        int getMaxLayers() const { return mMaxLayers; }
+        
+        /**
+         *  Draw layers in one shader pass per maxLayers layers, blended bottom to top with current color.
+         *  When exactly one layer at opacity 1, the texture is drawn directly without shader.
+         *
+         *  @param layers       Layer textures, smaller layers are upsampled with their texture filter
+         *  @param opacities    Opacity of each layer (0.0-1.0)
+         */
+        void draw(const vector<ofTexture*>& layers, const vector<float>& opacities, const float x, const float y, const float z, const float width, const float height);
+    };
+}
@@ -0,0 +1,100 @@
+#include "ofxContentsManagerFboPool.h"
+
+static const string MODULE_NAME = "ofxContentsManager::FboPool";
+
+namespace ofxContentsManager
+{
+    FboPool::FboPool()
+    : mMaxFbos(0)
+    {
+    }
+    
+    FboPool::~FboPool()
+    {
+        clear();
+    }
+    
+    void FboPool::setup(const ofFbo::Settings& settings, const int maxFbos)
+    {
+        mSettings = settings;
+        setMaxFbos(maxFbos);
+    }
+    
+    void FboPool::allocate(const ofFbo::Settings& settings)
+    {
+        mSettings = settings;
+        for (auto& fbo : mFreeFbos)
+        {
+            mFbos.erase(find(mFbos.begin(), mFbos.end(), fbo));
+            delete fbo;
+        }
+        mFreeFbos.clear();
+    }
+    
+    ofFbo* FboPool::acquire(const int width, const int height)
+    {
+        ofFbo::Settings settings = mSettings;
+        if (width > 0) settings.width = width;
+        if (height > 0) settings.height = height;
+        
+        for (vector<ofFbo*>::iterator it = mFreeFbos.begin(); it != mFreeFbos.end(); ++it)
+        {
+            ofFbo* fbo = *it;
+            if (fbo->getWidth() == settings.width && fbo->getHeight() == settings.height)
+            {
+                mFreeFbos.erase(it);
+                return fbo;
+            }
+        }
+        if (mFbos.size() < mMaxFbos)
+        {
+            ofFbo* fbo = new ofFbo();
+            fbo->allocate(settings);
+            mFbos.push_back(fbo);
+            return fbo;
+        }
+        if (!mFreeFbos.empty())
+        {
+            // no free frame buffer of this size, resize one
+            ofFbo* fbo = mFreeFbos.back();
+            mFreeFbos.pop_back();
+            fbo->allocate(settings);
+            return fbo;
+        }
+        return NULL;
+    }
+    
+    void FboPool::release(ofFbo* fbo)
+    {
+        if (fbo == NULL) return;
+        if (find(mFbos.begin(), mFbos.end(), fbo) == mFbos.end())
+        {
+            ofLogError(MODULE_NAME) << "released frame buffer is not owned by this pool";
+            return;
+        }
+        mFreeFbos.push_back(fbo);
+        setMaxFbos(mMaxFbos);
+    }
+    
+    void FboPool::setMaxFbos(const int maxFbos)
+    {
+        mMaxFbos = max(maxFbos, 0);
+        while (mFbos.size() > mMaxFbos && !mFreeFbos.empty())
+        {
+            ofFbo* fbo = mFreeFbos.back();
+            mFreeFbos.pop_back();
+            mFbos.erase(find(mFbos.begin(), mFbos.end(), fbo));
+            delete fbo;
+        }
+    }
+    
+    void FboPool::clear()
+    {
+        for (auto& fbo : mFbos)
+        {
+            delete fbo;
+        }
+        mFbos.clear();
+        mFreeFbos.clear();
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ofMain.h"
+
+namespace ofxContentsManager
+{
+    //---------------------------------------------------------------------------------------
+    /*
+        FRAME BUFFER POOL CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    class FboPool
+    {
+        vector<ofFbo*>      mFbos;
+        vector<ofFbo*>      mFreeFbos;
+        ofFbo::Settings     mSettings;
+        int                 mMaxFbos;
+        
+    public:
+        FboPool();
+        virtual ~FboPool();
+        
+        /**
+         *  Setup pool
+         *
+         *  @param settings ofFbo settings for every frame buffer of the pool
+         *  @param maxFbos  Maximum number of frame buffers the pool will allocate
+         */
+        void setup(const ofFbo::Settings& settings, const int maxFbos);
+        
+        /**
+         *  Change settings, free frame buffers are deallocated and leased ones are kept until released
+         *
+         *  @param settings ofFbo settings
+         */
+        void allocate(const ofFbo::Settings& settings);
+        
+        /**
+         *  Lease a frame buffer, a released frame buffer of the same size is reused without reallocation
+         *
+         *  @param width    Frame buffer width (default = 0, settings width)
+         *  @param height   Frame buffer height (default = 0, settings height)
+         *
+         *  @return Frame buffer pointer, or NULL when the pool is exhausted
+         */
+        ofFbo* acquire(const int width = 0, const int height = 0);
+        
+        /**
+         *  Give back a leased frame buffer
+         *
+         *  @param fbo Frame buffer pointer offered from acquire()
+         */
+        void release(ofFbo* fbo);
+        
+        /**
+         *  Set maximum number of frame buffers, free frame buffers over the limit are deallocated
+         *
+         *  @param maxFbos Maximum number
+         */
+        void setMaxFbos(const int maxFbos);
+        
+        int getMaxFbos() const { return mMaxFbos; }
+        int getNumAllocated() const { return mFbos.size(); }
+        int getNumLeased() const { return mFbos.size() - mFreeFbos.size(); }
+        
+        /**
+         *  Deallocate all frame buffers, leased buffers become invalid
+         */
+        void clear();
+    };
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "ofMain.h"
+
+namespace ofxContentsManager
+{
+    /**
+     *  Stable reference to a content in a manager, unlike the order of instances it is not shifted
+     *  by removing other contents. A handle of a removed content is detected as invalid.
+     */
+    struct ContentHandle
+    {
+        uint32_t slot;
+        uint32_t generation; ///< 0 is null handle
+        
+        ContentHandle() : slot(0), generation(0) {}
+        ContentHandle(uint32_t slot, uint32_t generation) : slot(slot), generation(generation) {}
+        
+        bool isNull() const { return generation == 0; }
+        bool operator==(const ContentHandle& h) const { return slot == h.slot && generation == h.generation; }
+        bool operator!=(const ContentHandle& h) const { return !(*this == h); }
+    };
+}
@@ -0,0 +1,124 @@
+#include "ofxContentsManagerImageSequenceWriter.h"
+#include <cstring>
+
+static const string MODULE_NAME = "ofxContentsManager::ImageSequenceWriter";
+
+namespace ofxContentsManager
+{
+    ImageSequenceWriter::ImageSequenceWriter()
+    : mMaxQueued(8)
+    , mNumWritten(0)
+    , mNumFailed(0)
+    , bWriting(false)
+    , bExit(false)
+    {
+    }
+    
+    ImageSequenceWriter::~ImageSequenceWriter()
+    {
+        close();
+        for (auto& pixels : mFreePixels)
+        {
+            delete pixels;
+        }
+    }
+    
+    bool ImageSequenceWriter::setup(const string& directory, const string& extension, const int maxQueued)
+    {
+        close();
+        
+        // lossy formats would defeat the deterministic output
+        const string format = ofToLower(extension);
+        if (format != "png" && format != "tif" && format != "tiff" && format != "bmp")
+        {
+            ofLogError(MODULE_NAME) << "unsupported image format: " << extension;
+            return false;
+        }
+        if (!ofDirectory::doesDirectoryExist(directory) && !ofDirectory::createDirectory(directory, true, true))
+        {
+            ofLogError(MODULE_NAME) << "failed to create directory: " << directory;
+            return false;
+        }
+        mDirectory = directory;
+        mExtension = extension;
+        mMaxQueued = max(maxQueued, 1);
+        mNumWritten = 0;
+        mNumFailed = 0;
+        bExit = false;
+        bWriting = true;
+        mThread = thread(&ImageSequenceWriter::threadedFunction, this);
+        return true;
+    }
+    
+    void ImageSequenceWriter::push(const unsigned char* rgba, const int width, const int height, const uint64_t frameNumber, const bool flip)
+    {
+        if (!bWriting) return;
+        
+        ofPixels* pixels = NULL;
+        {
+            // back pressure, frames are never dropped
+            unique_lock<mutex> lock(mMutex);
+            mCondition.wait(lock, [this]{ return (int)mQueue.size() < mMaxQueued; });
+            if (!mFreePixels.empty())
+            {
+                pixels = mFreePixels.back();
+                mFreePixels.pop_back();
+            }
+        }
+        if (pixels == NULL) pixels = new ofPixels();
+        
+        if (pixels->getWidth() != (size_t)width || pixels->getHeight() != (size_t)height) pixels->allocate(width, height, 4);
+        const size_t stride = width * 4;
+        for (int y = 0; y < height; ++y)
+        {
+            memcpy(pixels->getData() + y * stride, rgba + (flip ? height - 1 - y : y) * stride, stride);
+        }
+        
+        {
+            lock_guard<mutex> lock(mMutex);
+            mQueue.push_back(make_pair(pixels, frameNumber));
+        }
+        mCondition.notify_all();
+    }
+    
+    void ImageSequenceWriter::close()
+    {
+        if (!mThread.joinable()) return;
+        {
+            lock_guard<mutex> lock(mMutex);
+            bExit = true;
+        }
+        mCondition.notify_all();
+        mThread.join();
+        bWriting = false;
+    }
+    
+    void ImageSequenceWriter::threadedFunction()
+    {
+        while (true)
+        {
+            pair<ofPixels*, uint64_t> frame;
+            {
+                unique_lock<mutex> lock(mMutex);
+                mCondition.wait(lock, [this]{ return bExit || !mQueue.empty(); });
+                if (mQueue.empty()) return; // exit after queued frames are written
+                frame = mQueue.front();
+            }
+            
+            const string path = mDirectory + "/frame_" + ofToString(frame.second, 6, '0') + "." + mExtension;
+            if (ofSaveImage(*frame.first, path)) ++mNumWritten;
+            else
+            {
+                ofLogError(MODULE_NAME) << "failed to save: " << path;
+                ++mNumFailed;
+            }
+            
+            {
+                lock_guard<mutex> lock(mMutex);
+                mQueue.pop_front();
+                mFreePixels.push_back(frame.first);
+            }
+            mCondition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ofMain.h"
+
+namespace ofxContentsManager
+{
+    //---------------------------------------------------------------------------------------
+    /*
+        IMAGE SEQUENCE WRITER CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    /**
+     *  Save frames as numbered image files on a writer thread
+     */
+    class ImageSequenceWriter
+    {
+        thread                      mThread;
+        mutex                       mMutex;
+        condition_variable          mCondition;
+        deque<pair<ofPixels*, uint64_t> > mQueue;
+        vector<ofPixels*>           mFreePixels;
+        string                      mDirectory;
+        string                      mExtension;
+        int                         mMaxQueued;
+        atomic<uint64_t>            mNumWritten;
+        atomic<uint64_t>            mNumFailed;
+        bool                        bWriting;
+        bool                        bExit;
+        
+        void threadedFunction();
+        
+    public:
+        ImageSequenceWriter();
+        virtual ~ImageSequenceWriter();
+        
+        /**
+         *  Start writer thread
+         *
+         *  @param directory    Output directory, relative to data path (created if not exist)
+         *  @param extension    Image format, lossless "png" (default), "tif", "tiff" or "bmp", others are rejected
+         *  @param maxQueued    Frames waiting for write, push() blocks when full (default = 8)
+         *
+         *  @return is setup succeed
+         */
+        bool setup(const string& directory, const string& extension = "png", const int maxQueued = 8);
+        
+        /**
+         *  Queue a frame, file name is frame_<frameNumber>.<extension>
+         *
+         *  @param rgba         width * height * 4 bytes
+         *  @param width        Frame width
+         *  @param height       Frame height
+         *  @param frameNumber  Frame number
+         *  @param flip         Rows are bottom-up (GL order) (default = true)
+         */
+        void push(const unsigned char* rgba, const int width, const int height, const uint64_t frameNumber, const bool flip = true);
+        
+        /**
+         *  Write all queued frames and stop writer thread
+         */
+        void close();
+        
+        bool isWriting() const { return bWriting; }
+        uint64_t getNumWritten() const { return mNumWritten; }
+        uint64_t getNumFailed() const { return mNumFailed; }
+    };
+}
@@ -0,0 +1,92 @@
+#include "ofxContentsManagerLoader.h"
+#include "ofxContentsManager.h"
+
+namespace ofxContentsManager
+{
+    Loader::Loader()
+    : mLoading(NULL)
+    , bExit(false)
+    {
+    }
+    
+    Loader::~Loader()
+    {
+        close();
+    }
+    
+    void Loader::push(Content* content)
+    {
+        {
+            lock_guard<mutex> lock(mMutex);
+            if (!mThread.joinable())
+            {
+                bExit = false;
+                mThread = thread(&Loader::threadedFunction, this);
+            }
+            mPending.push_back(content);
+        }
+        mCondition.notify_all();
+    }
+    
+    bool Loader::pop(Content*& content, bool& succeed)
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (mFinished.empty()) return false;
+        content = mFinished.front().first;
+        succeed = mFinished.front().second;
+        mFinished.pop_front();
+        return true;
+    }
+    
+    void Loader::cancel(Content* content)
+    {
+        unique_lock<mutex> lock(mMutex);
+        mPending.erase(remove(mPending.begin(), mPending.end(), content), mPending.end());
+        mCondition.wait(lock, [&]{ return mLoading != content; });
+        for (deque<pair<Content*, bool> >::iterator it = mFinished.begin(); it != mFinished.end(); ++it)
+        {
+            if (it->first == content)
+            {
+                mFinished.erase(it);
+                break;
+            }
+        }
+    }
+    
+    void Loader::close()
+    {
+        {
+            lock_guard<mutex> lock(mMutex);
+            bExit = true;
+            mPending.clear();
+        }
+        mCondition.notify_all();
+        if (mThread.joinable()) mThread.join();
+        mFinished.clear();
+    }
+    
+    void Loader::threadedFunction()
+    {
+        while (true)
+        {
+            Content* content;
+            {
+                unique_lock<mutex> lock(mMutex);
+                mCondition.wait(lock, [this]{ return bExit || !mPending.empty(); });
+                if (bExit) return;
+                content = mPending.front();
+                mPending.pop_front();
+                mLoading = content;
+            }
+            
+            const bool succeed = content->load();
+            
+            {
+                lock_guard<mutex> lock(mMutex);
+                mLoading = NULL;
+                mFinished.push_back(make_pair(content, succeed));
+            }
+            mCondition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "ofMain.h"
+
+namespace ofxContentsManager
+{
+    class Content;
+    
+    //---------------------------------------------------------------------------------------
+    /*
+        BACKGROUND LOADER CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    class Loader
+    {
+        thread                          mThread;
+        mutex                           mMutex;
+        condition_variable              mCondition;
+        deque<Content*>                 mPending;
+        deque<pair<Content*, bool> >    mFinished;
+        Content*                        mLoading;
+        bool                            bExit;
+        
+        void threadedFunction();
+        
+    public:
+        Loader();
+        virtual ~Loader();
+        
+        /**
+         *  Queue content, Content::load() is called on the loader thread
+         *
+         *  @param content Content pointer
+         */
+        void push(Content* content);
+        
+        /**
+         *  Offer a content that finished load(), call from main thread
+         *
+         *  @param content  Finished content
+         *  @param succeed  Result of load()
+         *
+         *  @return false if no content finished
+         */
+        bool pop(Content*& content, bool& succeed);
+        
+        /**
+         *  Remove content from the queue. If the content is loading now, this blocks the calling thread
+         *  until load() returns, so the content can be freed right after
+         *
+         *  @param content Content pointer
+         */
+        void cancel(Content* content);
+        
+        /**
+         *  Stop and join the loader thread
+         */
+        void close();
+    };
+}
@@ -0,0 +1,127 @@
+#include "ofxContentsManagerOutput.h"
+
+namespace
+{
+    ofTexture& getTexture(ofFbo& fbo)
+    {
+#if (OF_VERSION_MAJOR == 0 && OF_VERSION_MINOR < 9)
+        return fbo.getTextureReference();
+#else
+        return fbo.getTexture();
+#endif
+    }
+}
+
+namespace ofxContentsManager
+{
+    Output::Output()
+    : mWidth(0)
+    , mHeight(0)
+    , bEnabled(true)
+    {
+    }
+    
+    Output::~Output()
+    {
+        for (auto& fbo : mChain)
+        {
+            delete fbo;
+        }
+    }
+    
+    void Output::setup(const string& name, const int width, const int height, const ofFbo::Settings& settings)
+    {
+        mName = name;
+        mWidth = max(width, 1);
+        mHeight = max(height, 1);
+        
+        ofFbo::Settings s = settings;
+        s.width = mWidth;
+        s.height = mHeight;
+        s.numSamples = 0;
+        s.useDepth = false;
+        s.useStencil = false;
+        s.minFilter = GL_LINEAR;
+        s.maxFilter = GL_LINEAR;
+        mFbo.allocate(s);
+        
+        // each level is twice the next, so a linear sample of a level is a 2x2 box filter
+        int levels = 0;
+        while ((mWidth << (levels + 1)) <= settings.width && (mHeight << (levels + 1)) <= settings.height) ++levels;
+        
+        for (auto& fbo : mChain)
+        {
+            delete fbo;
+        }
+        mChain.resize(levels);
+        for (int i = 0; i < levels; ++i)
+        {
+            s.width = mWidth << (levels - i);
+            s.height = mHeight << (levels - i);
+            mChain[i] = new ofFbo();
+            mChain[i]->allocate(s);
+        }
+    }
+    
+    void Output::downsample()
+    {
+        if (mChain.empty()) return;
+        
+        ofPushStyle();
+        ofDisableBlendMode();
+        ofSetColor(255);
+        for (int i = 0; i < mChain.size(); ++i)
+        {
+            ofFbo& dst = i + 1 < mChain.size() ? *mChain[i + 1] : mFbo;
+            dst.begin();
+            ::getTexture(*mChain[i]).draw(0, 0, dst.getWidth(), dst.getHeight());
+            dst.end();
+        }
+        ofPopStyle();
+    }
+    
+    void Output::addLayer(const ContentHandle& handle)
+    {
+        if (find(mLayers.begin(), mLayers.end(), handle) == mLayers.end()) mLayers.push_back(handle);
+    }
+    
+    void Output::removeLayer(const ContentHandle& handle)
+    {
+        mLayers.erase(remove(mLayers.begin(), mLayers.end(), handle), mLayers.end());
+    }
+    
+    void Output::setOpacity(const ContentHandle& handle, const float opacity)
+    {
+        for (auto& e : mOpacities)
+        {
+            if (e.first == handle)
+            {
+                e.second = ofClamp(opacity, 0, 1);
+                return;
+            }
+        }
+        mOpacities.push_back(make_pair(handle, ofClamp(opacity, 0, 1)));
+    }
+    
+    void Output::clearOpacity(const ContentHandle& handle)
+    {
+        for (auto it = mOpacities.begin(); it != mOpacities.end(); ++it)
+        {
+            if (it->first == handle)
+            {
+                mOpacities.erase(it);
+                return;
+            }
+        }
+    }
+    
+    ofTexture& Output::getTexture()
+    {
+        return ::getTexture(mFbo);
+    }
+    
+    void Output::draw(const float x, const float y, const float width, const float height)
+    {
+        ::getTexture(mFbo).draw(x, y, width, height);
+    }
+}
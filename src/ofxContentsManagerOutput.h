@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxContentsManagerHandle.h"
+
+namespace ofxContentsManager
+{
+    //---------------------------------------------------------------------------------------
+    /*
+        OUTPUT TARGET CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    /**
+     *  Named output composited by the manager from the contents' frame buffers,
+     *  with its own size, layer subset and opacity overrides
+     */
+    class Output
+    {
+        string                  mName;
+        int                     mWidth;
+        int                     mHeight;
+        ofFbo                   mFbo;
+        vector<ofFbo*>          mChain;     // halving levels above the output size, composited into the first one
+        vector<ContentHandle>   mLayers;
+        vector<pair<ContentHandle, float> > mOpacities;
+        bool                    bEnabled;
+        
+    public:
+        Output();
+        virtual ~Output();
+        
+        /**
+         *  Allocate frame buffers. When the output is smaller than half of the manager's buffer,
+         *  layers are composited at the output size * 2^n (up to the buffer size) and halved down to the output size.
+         *
+         *  @param name         Output name
+         *  @param width        Output width
+         *  @param height       Output height
+         *  @param settings     Manager's frame buffer settings
+         */
+        void setup(const string& name, const int width, const int height, const ofFbo::Settings& settings);
+        
+        /**
+         *  Offer the frame buffer layers are composited into
+         *
+         *  @return ofFbo reference, first level of the downsample chain or the output itself
+         */
+        ofFbo& getCompositeBuffer() { return mChain.empty() ? mFbo : *mChain.front(); }
+        
+        /**
+         *  Reduce the composite buffer to the output size through the downsample chain
+         */
+        void downsample();
+        
+        /**
+         *  Setting layer subset, only these contents are composited in order of instances
+         *
+         *  @param layers Content handles (empty = every content, default)
+         */
+        void setLayers(const vector<ContentHandle>& layers) { mLayers = layers; }
+        void addLayer(const ContentHandle& handle);
+        void removeLayer(const ContentHandle& handle);
+        void clearLayers() { mLayers.clear(); }
+        const vector<ContentHandle>& getLayers() const { return mLayers; }
+        bool hasLayers() const { return !mLayers.empty(); }
+        
+        /**
+         *  Setting opacity of a content in this output instead of the manager's opacity,
+         *  a content hidden in the manager is rendered when its override is over zero
+         *
+         *  @param handle   Target content's handle
+         *  @param opacity  Opacity (0 - 1)
+         */
+        void setOpacity(const ContentHandle& handle, const float opacity);
+        void clearOpacity(const ContentHandle& handle);
+        void clearOpacities() { mOpacities.clear(); }
+        const vector<pair<ContentHandle, float> >& getOpacities() const { return mOpacities; }
+        
+        /**
+         *  Setting composite of this output in the manager update (default is enable)
+         *
+         *  @param enable true or false
+         */
+        void setEnabled(bool enable) { bEnabled = enable; }
+        bool isEnabled() const { return bEnabled; }
+        
+        ofTexture& getTexture();
+        void draw(const float x, const float y) { draw(x, y, mWidth, mHeight); }
+        void draw(const float x, const float y, const float width, const float height);
+        
+        const string& getName() const { return mName; }
+        int getWidth() const { return mWidth; }
+        int getHeight() const { return mHeight; }
+        int getNumLevels() const { return mChain.size(); }
+    };
+}
@@ -0,0 +1,132 @@
+#include "ofxContentsManagerProfiler.h"
+
+namespace ofxContentsManager
+{
+    //---------------------------------------------------------------------------------------
+    /*
+     ROLLING TIMER CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    RollingTimer::RollingTimer(const int numSamples)
+    : mSamples(max(numSamples, 1), 0.0)
+    , mNext(0)
+    , mNumSamples(0)
+    , mLast(0)
+    {
+    }
+    
+    void RollingTimer::add(const float ms)
+    {
+        mSamples[mNext] = ms;
+        mNext = (mNext + 1) % mSamples.size();
+        mNumSamples = min(mNumSamples + 1, (int)mSamples.size());
+        mLast = ms;
+    }
+    
+    void RollingTimer::clear()
+    {
+        mNext = 0;
+        mNumSamples = 0;
+        mLast = 0;
+    }
+    
+    float RollingTimer::getAverage() const
+    {
+        if (mNumSamples == 0) return 0;
+        float sum = 0;
+        for (int i = 0; i < mNumSamples; ++i) sum += mSamples[i];
+        return sum / mNumSamples;
+    }
+    
+    TimingStats RollingTimer::getStats() const
+    {
+        TimingStats stats;
+        stats.numSamples = mNumSamples;
+        stats.last = mLast;
+        if (mNumSamples == 0) return stats;
+        
+        vector<float> sorted(mSamples.begin(), mSamples.begin() + mNumSamples);
+        sort(sorted.begin(), sorted.end());
+        stats.average = getAverage();
+        stats.median = sorted[(mNumSamples - 1) * 50 / 100];
+        stats.p95 = sorted[(mNumSamples - 1) * 95 / 100];
+        stats.p99 = sorted[(mNumSamples - 1) * 99 / 100];
+        stats.max = sorted.back();
+        return stats;
+    }
+    
+    
+    
+    //---------------------------------------------------------------------------------------
+    /*
+     GPU TIMER CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    // GL_TIME_ELAPSED queries can not nest, e.g. a manager nested as a content
+    static bool sGpuTimerActive = false;
+    
+    GpuTimer::GpuTimer(const int numQueries)
+    : mQueries(max(numQueries, 1), 0)
+    , mPending(max(numQueries, 1), false)
+    , mNext(0)
+    , bActive(false)
+    {
+    }
+    
+    GpuTimer::~GpuTimer()
+    {
+#ifdef GL_TIME_ELAPSED
+        if (mQueries[0] != 0) glDeleteQueries(mQueries.size(), &mQueries[0]);
+#endif
+    }
+    
+    void GpuTimer::begin()
+    {
+#ifdef GL_TIME_ELAPSED
+        if (sGpuTimerActive) return;
+        if (mQueries[0] == 0) glGenQueries(mQueries.size(), &mQueries[0]);
+        
+        poll();
+        if (mPending[mNext]) return; // all queries in flight, drop this sample
+        
+        glBeginQuery(GL_TIME_ELAPSED, mQueries[mNext]);
+        sGpuTimerActive = true;
+        bActive = true;
+#endif
+    }
+    
+    void GpuTimer::end()
+    {
+#ifdef GL_TIME_ELAPSED
+        if (!bActive) return;
+        glEndQuery(GL_TIME_ELAPSED);
+        mPending[mNext] = true;
+        mNext = (mNext + 1) % mQueries.size();
+        sGpuTimerActive = false;
+        bActive = false;
+#endif
+    }
+    
+    void GpuTimer::poll()
+    {
+#ifdef GL_TIME_ELAPSED
+        // oldest first, so samples keep frame order
+        for (int n = 0; n < mQueries.size(); ++n)
+        {
+            const int i = (mNext + n) % mQueries.size();
+            if (!mPending[i]) continue;
+            
+            GLint available = 0;
+            glGetQueryObjectiv(mQueries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+            
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(mQueries[i], GL_QUERY_RESULT, &ns);
+            mTimer.add(ns / 1000000.0);
+            mPending[i] = false;
+        }
+#endif
+    }
+}
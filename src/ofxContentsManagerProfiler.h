@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ofMain.h"
+
+// Set to 0 to compile out all profiling instrumentation (default is off when NDEBUG is defined)
+#ifndef OFX_CONTENTS_MANAGER_PROFILER
+#   ifdef NDEBUG
+#       define OFX_CONTENTS_MANAGER_PROFILER 0
+#   else
+#       define OFX_CONTENTS_MANAGER_PROFILER 1
+#   endif
+#endif
+
+namespace ofxContentsManager
+{
+    /**
+     *  Rolling timing statistics, in milliseconds
+     */
+    struct TimingStats
+    {
+        float   last;
+        float   average;
+        float   median;
+        float   p95;
+        float   p99;
+        float   max;
+        int     numSamples;
+        
+        TimingStats() : last(0), average(0), median(0), p95(0), p99(0), max(0), numSamples(0){}
+    };
+    
+    /**
+     *  Timing statistics of one content
+     */
+    struct ContentStats
+    {
+        string      name;
+        TimingStats update;     ///< CPU time of update()
+        TimingStats draw;       ///< CPU time of rendering draw() into the frame buffer
+        TimingStats gpu;        ///< GPU time of rendering draw() into the frame buffer
+    };
+    
+    //---------------------------------------------------------------------------------------
+    /*
+        ROLLING TIMER CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    class RollingTimer
+    {
+        vector<float>   mSamples;
+        int             mNext;
+        int             mNumSamples;
+        float           mLast;
+        
+    public:
+        RollingTimer(const int numSamples = 120);
+        
+        void add(const float ms);
+        void clear();
+        
+        float getLast() const { return mLast; }
+        float getAverage() const;
+        TimingStats getStats() const;
+    };
+    
+    //---------------------------------------------------------------------------------------
+    /*
+        GPU TIMER CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    class GpuTimer
+    {
+        vector<GLuint>  mQueries;
+        vector<bool>    mPending;
+        int             mNext;
+        bool            bActive;
+        RollingTimer    mTimer;
+        
+    public:
+        GpuTimer(const int numQueries = 4);
+        virtual ~GpuTimer();
+        
+        /**
+         *  Begin GL_TIME_ELAPSED query, skipped when the next query is still in flight
+         *  or another GpuTimer is active (queries can not nest)
+         */
+        void begin();
+        void end();
+        
+        /**
+         *  Read back finished queries without blocking
+         */
+        void poll();
+        
+        const RollingTimer& getTimer() const { return mTimer; }
+    };
+}
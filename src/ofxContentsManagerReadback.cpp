@@ -0,0 +1,188 @@
+#include "ofxContentsManagerReadback.h"
+
+static const string MODULE_NAME = "ofxContentsManager::Readback";
+
+namespace ofxContentsManager
+{
+    Readback::Readback()
+    : mNext(0)
+    , mWidth(0)
+    , mHeight(0)
+    , bDropFrames(true)
+    , mNumRequested(0)
+    , mNumDelivered(0)
+    , mNumDropped(0)
+    , mLatencyFrames(0)
+    {
+    }
+    
+    Readback::~Readback()
+    {
+        close();
+    }
+    
+    void Readback::setup(const int width, const int height, const int numBuffers)
+    {
+        close();
+        mWidth = width;
+        mHeight = height;
+        mSlots.resize(max(numBuffers, 2));
+        for (auto& slot : mSlots)
+        {
+            glGenBuffers(1, &slot.pbo);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, NULL, GL_STREAM_READ);
+            slot.fence = NULL;
+            slot.pending = false;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        mNext = 0;
+        if (mSharedFrames.isOpen() && (mSharedFrames.getWidth() != width || mSharedFrames.getHeight() != height))
+        {
+            ofLogWarning(MODULE_NAME) << "frame size changed, shared memory is closed";
+            mSharedFrames.close();
+        }
+    }
+    
+    void Readback::close()
+    {
+        for (auto& slot : mSlots)
+        {
+            discard(slot);
+            glDeleteBuffers(1, &slot.pbo);
+        }
+        mSlots.clear();
+    }
+    
+    void Readback::read(ofFbo& fbo)
+    {
+        if (mSlots.empty()) return;
+        
+        poll();
+        Slot& slot = mSlots[mNext];
+        if (slot.pending)
+        {
+            // every buffer is in flight, the GPU or the consumer is behind
+            if (bDropFrames)
+            {
+                discard(slot);
+                ++mNumDropped;
+            }
+            else deliver(slot);
+        }
+        
+        GLint previous = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo.getId());
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, mWidth, mHeight, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, previous);
+        
+#ifdef GL_SYNC_GPU_COMMANDS_COMPLETE
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+        slot.pending = true;
+        slot.frameNumber = mNumRequested++;
+        slot.issued = ofGetElapsedTimeMicros();
+        mNext = (mNext + 1) % mSlots.size();
+    }
+    
+    void Readback::poll()
+    {
+        // oldest first, so frames are delivered in order
+        for (int n = 0; n < mSlots.size(); ++n)
+        {
+            Slot& slot = mSlots[(mNext + n) % mSlots.size()];
+            if (!slot.pending) continue;
+            if (!isComplete(slot)) break;
+            deliver(slot);
+        }
+    }
+    
+    void Readback::flush()
+    {
+        for (int n = 0; n < mSlots.size(); ++n)
+        {
+            Slot& slot = mSlots[(mNext + n) % mSlots.size()];
+            if (slot.pending) deliver(slot);
+        }
+    }
+    
+    bool Readback::isComplete(Slot& slot)
+    {
+#ifdef GL_SYNC_GPU_COMMANDS_COMPLETE
+        if (slot.fence)
+        {
+            const GLenum result = glClientWaitSync((GLsync)slot.fence, 0, 0);
+            return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+        }
+#endif
+        // without fences, assume the GPU finished after the ring went around
+        return mNumRequested - slot.frameNumber >= mSlots.size() - 1;
+    }
+    
+    void Readback::deliver(Slot& slot)
+    {
+#ifdef GL_SYNC_GPU_COMMANDS_COMPLETE
+        if (slot.fence)
+        {
+            glClientWaitSync((GLsync)slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000); // 1s
+            glDeleteSync((GLsync)slot.fence);
+            slot.fence = NULL;
+        }
+#endif
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+#ifdef TARGET_OPENGLES
+        const unsigned char* pixels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)mWidth * mHeight * 4, GL_MAP_READ_BIT);
+#else
+        const unsigned char* pixels = (const unsigned char*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+#endif
+        if (pixels)
+        {
+            ReadbackFrame frame;
+            frame.pixels = pixels;
+            frame.width = mWidth;
+            frame.height = mHeight;
+            frame.frameNumber = slot.frameNumber;
+            frame.latency = (ofGetElapsedTimeMicros() - slot.issued) / 1000.0;
+            
+            mLatency.add(frame.latency);
+            mLatencyFrames = mNumRequested - slot.frameNumber;
+            ++mNumDelivered;
+            if (mCallback) mCallback(frame);
+            mSharedFrames.write(pixels, slot.frameNumber);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        else
+        {
+            ofLogError(MODULE_NAME) << "failed to map pixel buffer, frame is dropped: " << slot.frameNumber;
+            ++mNumDropped;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.pending = false;
+    }
+    
+    void Readback::discard(Slot& slot)
+    {
+#ifdef GL_SYNC_GPU_COMMANDS_COMPLETE
+        if (slot.fence)
+        {
+            glDeleteSync((GLsync)slot.fence);
+            slot.fence = NULL;
+        }
+#endif
+        slot.pending = false;
+    }
+    
+    bool Readback::openSharedMemory(const string& name, const int numSlots)
+    {
+        if (mWidth == 0 || mHeight == 0)
+        {
+            ofLogError(MODULE_NAME) << "readback is not setup";
+            return false;
+        }
+        return mSharedFrames.create(name, mWidth, mHeight, 4, numSlots);
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxContentsManagerProfiler.h"
+#include "ofxContentsManagerSharedFrameRing.h"
+
+namespace ofxContentsManager
+{
+    /**
+     *  A frame finished reading back, pixels are valid only in the callback
+     */
+    struct ReadbackFrame
+    {
+        const unsigned char*    pixels;         ///< RGBA, bottom-up rows
+        int                     width;
+        int                     height;
+        uint64_t                frameNumber;    ///< order of read() calls
+        float                   latency;        ///< milliseconds from read() to delivery
+    };
+    
+    //---------------------------------------------------------------------------------------
+    /*
+        ASYNC READBACK CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    /**
+     *  Read frame buffers back through a ring of pixel buffer objects,
+     *  a frame is delivered as soon as the GPU finished it, at most (numBuffers - 1) reads later, without stalling the pipeline
+     */
+    class Readback
+    {
+        struct Slot
+        {
+            GLuint              pbo;
+            void*               fence;          // GLsync
+            bool                pending;
+            uint64_t            frameNumber;
+            uint64_t            issued;
+        };
+        
+        vector<Slot>            mSlots;
+        int                     mNext;
+        int                     mWidth;
+        int                     mHeight;
+        bool                    bDropFrames;
+        
+        uint64_t                mNumRequested;
+        uint64_t                mNumDelivered;
+        uint64_t                mNumDropped;
+        int                     mLatencyFrames;
+        RollingTimer            mLatency;
+        
+        function<void(const ReadbackFrame&)> mCallback;
+        SharedFrameRing         mSharedFrames;
+        
+        bool isComplete(Slot& slot);
+        void deliver(Slot& slot);
+        void discard(Slot& slot);
+        
+    public:
+        Readback();
+        virtual ~Readback();
+        
+        /**
+         *  Setup pixel buffer objects, require GL context
+         *
+         *  @param width        Frame width
+         *  @param height       Frame height
+         *  @param numBuffers   Number of pixel buffer objects, frames in flight (default = 3)
+         */
+        void setup(const int width, const int height, const int numBuffers = 3);
+        
+        /**
+         *  Delete pixel buffer objects, pending frames are discarded
+         */
+        void close();
+        
+        /**
+         *  Start reading the frame buffer back and deliver finished frames
+         *
+         *  @param fbo Frame buffer of setup size, RGBA without multisampling
+         */
+        void read(ofFbo& fbo);
+        
+        /**
+         *  Deliver finished frames without blocking
+         */
+        void poll();
+        
+        /**
+         *  Deliver all pending frames, block until the GPU finished them
+         */
+        void flush();
+        
+        /**
+         *  Setting callback of finished frames, called on the GL thread in read(), poll() or flush()
+         *
+         *  @param callback function
+         */
+        void setCallback(const function<void(const ReadbackFrame&)>& callback) { mCallback = callback; }
+        const function<void(const ReadbackFrame&)>& getCallback() const { return mCallback; }
+        
+        /**
+         *  Setting drop policy when all pixel buffer objects are in flight
+         *
+         *  @param drop true: drop the oldest frame (default), false: wait for the oldest frame
+         */
+        void setDropFrames(bool drop) { bDropFrames = drop; }
+        bool getDropFrames() const { return bDropFrames; }
+        
+        /**
+         *  Publish finished frames to POSIX shared memory too
+         *
+         *  @param name     Shared memory name, e.g. "/ofxContentsManager"
+         *  @param numSlots Number of frames in the shared ring (default = 3)
+         *
+         *  @return is open succeed
+         */
+        bool openSharedMemory(const string& name, const int numSlots = 3);
+        void closeSharedMemory() { mSharedFrames.close(); }
+        const SharedFrameRing& getSharedMemory() const { return mSharedFrames; }
+        
+        bool isSetup() const { return !mSlots.empty(); }
+        int getWidth() const { return mWidth; }
+        int getHeight() const { return mHeight; }
+        int getNumBuffers() const { return mSlots.size(); }
+        
+        uint64_t getNumRequested() const { return mNumRequested; }
+        uint64_t getNumDelivered() const { return mNumDelivered; }
+        uint64_t getNumDropped() const { return mNumDropped; }
+        int getLatencyFrames() const { return mLatencyFrames; }     ///< reads between request and delivery of the last frame
+        const RollingTimer& getLatency() const { return mLatency; } ///< milliseconds
+    };
+}
@@ -0,0 +1,185 @@
+#include "ofxContentsManagerSharedFrameRing.h"
+#include <cstring>
+
+#ifndef TARGET_WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const string MODULE_NAME = "ofxContentsManager::SharedFrameRing";
+
+namespace
+{
+    const char MAGIC[8] = "OFXCMFR";
+    const uint32_t VERSION = 1;
+    const size_t ALIGNMENT = 64; // cache line, slots do not share lines
+    
+    size_t roundUp(const size_t value)
+    {
+        return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+}
+
+namespace ofxContentsManager
+{
+    SharedFrameRing::SharedFrameRing()
+    : mMemory(NULL)
+    , mSize(0)
+    , bOwner(false)
+    {
+    }
+    
+    SharedFrameRing::~SharedFrameRing()
+    {
+        close();
+    }
+    
+    SharedFrameSlot* SharedFrameRing::slot(const uint64_t n) const
+    {
+        SharedFrameHeader* h = header();
+        return (SharedFrameSlot*)((char*)mMemory + roundUp(sizeof(SharedFrameHeader)) + ((n - 1) % h->numSlots) * h->slotStride);
+    }
+    
+    bool SharedFrameRing::create(const string& name, const int width, const int height, const int channels, const int numSlots)
+    {
+        close();
+#ifndef TARGET_WIN32
+        const size_t slotStride = roundUp(sizeof(SharedFrameSlot) + (size_t)width * height * channels);
+        const size_t size = roundUp(sizeof(SharedFrameHeader)) + slotStride * max(numSlots, 1);
+        
+        shm_unlink(name.c_str());
+        const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0 || ftruncate(fd, size) != 0)
+        {
+            ofLogError(MODULE_NAME) << "failed to create shared memory: " << name;
+            if (fd >= 0) ::close(fd);
+            return false;
+        }
+        void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED)
+        {
+            ofLogError(MODULE_NAME) << "failed to map shared memory: " << name;
+            shm_unlink(name.c_str());
+            return false;
+        }
+        
+        mName = name;
+        mMemory = memory;
+        mSize = size;
+        bOwner = true;
+        
+        // new memory is zero filled, so every slot sequence starts at 0
+        SharedFrameHeader* h = header();
+        memcpy(h->magic, MAGIC, sizeof(MAGIC));
+        h->version = VERSION;
+        h->width = width;
+        h->height = height;
+        h->channels = channels;
+        h->numSlots = max(numSlots, 1);
+        h->slotStride = slotStride;
+        h->latest.store(0, std::memory_order_release);
+        return true;
+#else
+        ofLogError(MODULE_NAME) << "shared memory is not supported on this platform";
+        return false;
+#endif
+    }
+    
+    bool SharedFrameRing::open(const string& name)
+    {
+        close();
+#ifndef TARGET_WIN32
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SharedFrameHeader))
+        {
+            ofLogError(MODULE_NAME) << "failed to open shared memory: " << name;
+            if (fd >= 0) ::close(fd);
+            return false;
+        }
+        void* memory = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED)
+        {
+            ofLogError(MODULE_NAME) << "failed to map shared memory: " << name;
+            return false;
+        }
+        
+        const SharedFrameHeader* h = (const SharedFrameHeader*)memory;
+        if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 || h->version != VERSION)
+        {
+            ofLogError(MODULE_NAME) << "shared memory is not a frame ring: " << name;
+            munmap(memory, st.st_size);
+            return false;
+        }
+        
+        mName = name;
+        mMemory = memory;
+        mSize = st.st_size;
+        bOwner = false;
+        return true;
+#else
+        ofLogError(MODULE_NAME) << "shared memory is not supported on this platform";
+        return false;
+#endif
+    }
+    
+    void SharedFrameRing::close()
+    {
+#ifndef TARGET_WIN32
+        if (mMemory == NULL) return;
+        munmap(mMemory, mSize);
+        if (bOwner) shm_unlink(mName.c_str());
+#endif
+        mMemory = NULL;
+        mSize = 0;
+        bOwner = false;
+    }
+    
+    void SharedFrameRing::write(const unsigned char* pixels, const uint64_t frameNumber)
+    {
+        if (mMemory == NULL || !bOwner) return;
+        
+        SharedFrameHeader* h = header();
+        const uint64_t n = h->latest.load(std::memory_order_relaxed) + 1;
+        SharedFrameSlot* s = slot(n);
+        
+        // seqlock, readers retry or drop the frame while the sequence is odd or changed
+        s->sequence.store(2 * n - 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s->frameNumber = frameNumber;
+        s->timestamp = ofGetElapsedTimeMicros();
+        memcpy((char*)s + sizeof(SharedFrameSlot), pixels, (size_t)h->width * h->height * h->channels);
+        s->sequence.store(2 * n, std::memory_order_release);
+        h->latest.store(n, std::memory_order_release);
+    }
+    
+    const unsigned char* SharedFrameRing::getLatest(uint64_t& sequence) const
+    {
+        sequence = 0;
+        if (mMemory == NULL) return NULL;
+        
+        const uint64_t n = header()->latest.load(std::memory_order_acquire);
+        if (n == 0) return NULL;
+        const SharedFrameSlot* s = slot(n);
+        if (s->sequence.load(std::memory_order_acquire) != 2 * n) return NULL; // already being overwritten
+        sequence = n;
+        return (const unsigned char*)s + sizeof(SharedFrameSlot);
+    }
+    
+    bool SharedFrameRing::isValid(const uint64_t sequence) const
+    {
+        if (mMemory == NULL || sequence == 0) return false;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot(sequence)->sequence.load(std::memory_order_relaxed) == 2 * sequence;
+    }
+    
+    const SharedFrameSlot* SharedFrameRing::getSlot(const uint64_t sequence) const
+    {
+        if (mMemory == NULL || sequence == 0) return NULL;
+        return slot(sequence);
+    }
+}
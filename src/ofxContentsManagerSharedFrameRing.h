@@ -0,0 +1,126 @@
+#pragma once
+
+#include "ofMain.h"
+#include <atomic>
+
+namespace ofxContentsManager
+{
+    /**
+     *  Layout at the beginning of the shared memory, followed by numSlots slots of slotStride bytes.
+     *  Each slot is a SharedFrameSlot followed by width * height * channels bytes of pixels (bottom-up rows).
+     */
+    struct SharedFrameHeader
+    {
+        char                    magic[8];       ///< "OFXCMFR"
+        uint32_t                version;
+        uint32_t                width;
+        uint32_t                height;
+        uint32_t                channels;
+        uint32_t                numSlots;
+        uint32_t                reserved;
+        uint64_t                slotStride;
+        std::atomic<uint64_t>   latest;         ///< number of published frames, the latest is in slot (latest - 1) % numSlots
+    };
+    
+    struct SharedFrameSlot
+    {
+        std::atomic<uint64_t>   sequence;       ///< 2 * n when frame n (1-based) is published, odd while writing
+        uint64_t                frameNumber;
+        uint64_t                timestamp;      ///< microseconds of the producer's ofGetElapsedTimeMicros()
+        uint64_t                reserved;
+    };
+    
+    //---------------------------------------------------------------------------------------
+    /*
+        SHARED FRAME RING CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    /**
+     *  Single producer ring of frames in POSIX shared memory, lock-free seqlock per slot.
+     *  Consumers map it read only and read pixels in place.
+     */
+    class SharedFrameRing
+    {
+        string              mName;
+        void*               mMemory;
+        size_t              mSize;
+        bool                bOwner;
+        
+        SharedFrameHeader* header() const { return (SharedFrameHeader*)mMemory; }
+        SharedFrameSlot* slot(const uint64_t n) const;
+        
+    public:
+        SharedFrameRing();
+        virtual ~SharedFrameRing();
+        
+        /**
+         *  Create shared memory as the producer, existing memory of the name is replaced
+         *
+         *  @param name     Shared memory name, e.g. "/ofxContentsManager"
+         *  @param width    Frame width
+         *  @param height   Frame height
+         *  @param channels Bytes per pixel
+         *  @param numSlots Number of frames in the ring (default = 3)
+         *
+         *  @return is create succeed
+         */
+        bool create(const string& name, const int width, const int height, const int channels, const int numSlots = 3);
+        
+        /**
+         *  Map existing shared memory as a consumer
+         *
+         *  @param name Shared memory name
+         *
+         *  @return is open succeed
+         */
+        bool open(const string& name);
+        
+        /**
+         *  Unmap, the producer also unlinks the name
+         */
+        void close();
+        
+        /**
+         *  Publish a frame, call from the producer
+         *
+         *  @param pixels       width * height * channels bytes
+         *  @param frameNumber  Frame number stored with the frame
+         */
+        void write(const unsigned char* pixels, const uint64_t frameNumber);
+        
+        /**
+         *  Offer the latest published frame in place, without copy.
+         *  The pixels may be overwritten by the producer, check isValid() after using them.
+         *
+         *  @param sequence     Receive the frame's sequence (0 when no frame is published yet)
+         *
+         *  @return Pixels pointer, NULL when no frame is published yet
+         */
+        const unsigned char* getLatest(uint64_t& sequence) const;
+        
+        /**
+         *  Offer is the frame of the sequence not overwritten yet
+         *
+         *  @param sequence Sequence offered from getLatest()
+         *
+         *  @return true or false
+         */
+        bool isValid(const uint64_t sequence) const;
+        
+        /**
+         *  Offer the slot information of the frame
+         *
+         *  @param sequence Sequence offered from getLatest()
+         *
+         *  @return SharedFrameSlot pointer, NULL when not open
+         */
+        const SharedFrameSlot* getSlot(const uint64_t sequence) const;
+        
+        bool isOpen() const { return mMemory != NULL; }
+        int getWidth() const { return mMemory ? header()->width : 0; }
+        int getHeight() const { return mMemory ? header()->height : 0; }
+        int getNumChannels() const { return mMemory ? header()->channels : 0; }
+        int getNumSlots() const { return mMemory ? header()->numSlots : 0; }
+    };
+}
@@ -0,0 +1,72 @@
+#include "ofxContentsManagerStateGuard.h"
+
+namespace ofxContentsManager
+{
+    StateGuard::StateGuard()
+    : mDepthTest(GL_FALSE)
+    , mBlend(GL_FALSE)
+    , mBlendSrcRGB(GL_ONE)
+    , mBlendDstRGB(GL_ZERO)
+    , mBlendSrcAlpha(GL_ONE)
+    , mBlendDstAlpha(GL_ZERO)
+    , mBlendEquationRGB(GL_FUNC_ADD)
+    , mBlendEquationAlpha(GL_FUNC_ADD)
+    , mLineWidth(1)
+    , mProgram(0)
+    , bPushedAttrib(false)
+    , mIsolation(ISOLATE_NONE)
+    {
+        mViewport[0] = mViewport[1] = mViewport[2] = mViewport[3] = 0;
+    }
+    
+    void StateGuard::save(const StateIsolation isolation)
+    {
+        mIsolation = isolation;
+        bPushedAttrib = false;
+        if (mIsolation == ISOLATE_NONE) return;
+        
+#ifndef TARGET_OPENGLES
+        if (mIsolation == ISOLATE_ALL && !ofIsGLProgrammableRenderer())
+        {
+            glPushAttrib(GL_ALL_ATTRIB_BITS);
+            bPushedAttrib = true;
+            return;
+        }
+#endif
+        
+        // these are served from client-side state on common drivers, no pipeline stall
+        mDepthTest = glIsEnabled(GL_DEPTH_TEST);
+        mBlend = glIsEnabled(GL_BLEND);
+        glGetIntegerv(GL_BLEND_SRC_RGB, &mBlendSrcRGB);
+        glGetIntegerv(GL_BLEND_DST_RGB, &mBlendDstRGB);
+        glGetIntegerv(GL_BLEND_SRC_ALPHA, &mBlendSrcAlpha);
+        glGetIntegerv(GL_BLEND_DST_ALPHA, &mBlendDstAlpha);
+        glGetIntegerv(GL_BLEND_EQUATION_RGB, &mBlendEquationRGB);
+        glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &mBlendEquationAlpha);
+        glGetFloatv(GL_LINE_WIDTH, &mLineWidth);
+        glGetIntegerv(GL_VIEWPORT, mViewport);
+        glGetIntegerv(GL_CURRENT_PROGRAM, &mProgram);
+    }
+    
+    void StateGuard::restore()
+    {
+        if (mIsolation == ISOLATE_NONE) return;
+        
+#ifndef TARGET_OPENGLES
+        if (bPushedAttrib)
+        {
+            glPopAttrib();
+            bPushedAttrib = false;
+            return;
+        }
+#endif
+        
+        mDepthTest ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+        mBlend ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+        glBlendFuncSeparate(mBlendSrcRGB, mBlendDstRGB, mBlendSrcAlpha, mBlendDstAlpha);
+        glBlendEquationSeparate(mBlendEquationRGB, mBlendEquationAlpha);
+        glLineWidth(mLineWidth);
+        glViewport(mViewport[0], mViewport[1], mViewport[2], mViewport[3]);
+        glUseProgram(mProgram);
+    }
+}
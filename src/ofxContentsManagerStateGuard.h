@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ofMain.h"
+
+namespace ofxContentsManager
+{
+    /**
+     *  How much GL state the manager isolates around a content's draw()
+     */
+    enum StateIsolation
+    {
+        ISOLATE_NONE = 0,   ///< matrix and style only, for contents that restore what they change
+        ISOLATE_COMMON,     ///< also depth test, blend, line width, viewport and bound program (default)
+        ISOLATE_ALL         ///< glPushAttrib(GL_ALL_ATTRIB_BITS), fixed pipeline only, otherwise same as ISOLATE_COMMON
+    };
+    
+    //---------------------------------------------------------------------------------------
+    /*
+        GL STATE GUARD CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    class StateGuard
+    {
+        GLboolean   mDepthTest;
+        GLboolean   mBlend;
+        GLint       mBlendSrcRGB;
+        GLint       mBlendDstRGB;
+        GLint       mBlendSrcAlpha;
+        GLint       mBlendDstAlpha;
+        GLint       mBlendEquationRGB;
+        GLint       mBlendEquationAlpha;
+        GLfloat     mLineWidth;
+        GLint       mViewport[4];
+        GLint       mProgram;
+        bool        bPushedAttrib;
+        
+        StateIsolation mIsolation;
+        
+    public:
+        StateGuard();
+        
+        /**
+         *  Save GL state for the isolation level
+         *
+         *  @param isolation Isolation level
+         */
+        void save(const StateIsolation isolation);
+        
+        /**
+         *  Restore GL state saved by last save()
+         */
+        void restore();
+    };
+}
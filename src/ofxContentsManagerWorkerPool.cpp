@@ -0,0 +1,108 @@
+#include "ofxContentsManagerWorkerPool.h"
+
+namespace ofxContentsManager
+{
+    WorkerPool::WorkerPool()
+    : mTask(NULL)
+    , mNumTasks(0)
+    , mNextTask(0)
+    , mNumBusy(0)
+    , mGeneration(0)
+    , bExit(false)
+    {
+    }
+    
+    WorkerPool::~WorkerPool()
+    {
+        close();
+    }
+    
+    void WorkerPool::setup(const int numThreads)
+    {
+        close();
+        
+        int n = numThreads;
+        if (n <= 0) n = max((int)thread::hardware_concurrency() - 1, 1);
+        
+        bExit = false;
+        for (int i = 0; i < n; ++i)
+        {
+            mThreads.push_back(thread(&WorkerPool::threadedFunction, this));
+        }
+    }
+    
+    void WorkerPool::close()
+    {
+        {
+            lock_guard<mutex> lock(mMutex);
+            bExit = true;
+        }
+        mWorkCondition.notify_all();
+        for (auto& t : mThreads)
+        {
+            t.join();
+        }
+        mThreads.clear();
+        
+        // new threads start waiting for generation 1
+        mGeneration = 0;
+    }
+    
+    void WorkerPool::parallelFor(const int numTasks, const function<void(int)>& task)
+    {
+        if (numTasks <= 0) return;
+        if (mThreads.empty() || numTasks == 1)
+        {
+            for (int i = 0; i < numTasks; ++i) task(i);
+            return;
+        }
+        
+        {
+            lock_guard<mutex> lock(mMutex);
+            mTask = &task;
+            mNumTasks = numTasks;
+            mNextTask = 0;
+            mNumBusy = mThreads.size();
+            ++mGeneration;
+        }
+        mWorkCondition.notify_all();
+        
+        runTasks();
+        
+        // join barrier
+        unique_lock<mutex> lock(mMutex);
+        mDoneCondition.wait(lock, [this]{ return mNumBusy == 0; });
+        mTask = NULL;
+    }
+    
+    void WorkerPool::runTasks()
+    {
+        int i;
+        while ((i = mNextTask++) < mNumTasks)
+        {
+            (*mTask)(i);
+        }
+    }
+    
+    void WorkerPool::threadedFunction()
+    {
+        unsigned long generation = 0;
+        while (true)
+        {
+            {
+                unique_lock<mutex> lock(mMutex);
+                mWorkCondition.wait(lock, [&]{ return bExit || mGeneration != generation; });
+                if (bExit) return;
+                generation = mGeneration;
+            }
+            
+            runTasks();
+            
+            {
+                lock_guard<mutex> lock(mMutex);
+                --mNumBusy;
+            }
+            mDoneCondition.notify_one();
+        }
+    }
+}
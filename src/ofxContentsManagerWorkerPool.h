@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ofMain.h"
+
+namespace ofxContentsManager
+{
+    //---------------------------------------------------------------------------------------
+    /*
+        WORKER THREAD POOL CLASS
+     */
+    //---------------------------------------------------------------------------------------
+    
+    class WorkerPool
+    {
+        vector<thread>              mThreads;
+        mutex                       mMutex;
+        condition_variable          mWorkCondition;
+        condition_variable          mDoneCondition;
+        
+        const function<void(int)>*  mTask;
+        int                         mNumTasks;
+        atomic<int>                 mNextTask;
+        int                         mNumBusy;
+        unsigned long               mGeneration;
+        bool                        bExit;
+        
+        void threadedFunction();
+        void runTasks();
+        
+    public:
+        WorkerPool();
+        virtual ~WorkerPool();
+        
+        /**
+         *  Start worker threads
+         *
+         *  @param numThreads Number of worker threads (0 = hardware concurrency - 1)
+         */
+        void setup(const int numThreads = 0);
+        
+        /**
+         *  Stop and join worker threads
+         */
+        void close();
+        
+        int getNumThreads() const { return mThreads.size(); }
+        
+        /**
+         *  Run task(0) ... task(numTasks - 1) on worker threads and the calling thread,
+         *  return when all of tasks finished
+         *
+         *  @param numTasks Number of tasks
+         *  @param task     Task function, called with task index
+         */
+        void parallelFor(const int numTasks, const function<void(int)>& task);
+    };
+}